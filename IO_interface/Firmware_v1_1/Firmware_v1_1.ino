@@ -11,7 +11,8 @@
 
 
 
-Adafruit_AS7341 as7341;
+AS7341Driver as7341(AS7341_INT_PIN);
+AS7341AutoExposure as7341ae(as7341);
 AS7265X sensor;
 GxEPD2_DISPLAY_CLASS<GxEPD2_DRIVER_CLASS, MAX_HEIGHT(GxEPD2_DRIVER_CLASS)> display(GxEPD2_DRIVER_CLASS(/*CS=*/ 9, /*DC=*/ 8, /*RST=*/ 12, /*BUSY=*/ 13)); // Waveshare Pico-ePaper-2.9
 SPIClassRP2040 SPIn(spi1, -1, 13, 10, 11);
@@ -46,9 +47,7 @@ void setup()
   else if (as7341.begin() == true){ //if no AS7265x then check for AS7341
     sensecon = 2;
     bigText(false, "AS7341 Connected");
-    as7341.setATIME(100);
-    as7341.setASTEP(999);
-    as7341.setGain(AS7341_GAIN_32X);
+    as7341ae.begin(); //gain and integration are adjusted after every frame
     as7341.setLEDCurrent(20); //mA
   }
   else{
@@ -57,6 +56,20 @@ void setup()
   }
   delay(1000);
   drawEmpty(false, "Booted");
+  booted = true;
+}
+
+//----------------------------------------------------------------------------------------------------//
+// Core1 Set-Up & Loop (display)
+//----------------------------------------------------------------------------------------------------//
+void setup1()
+{
+  while(!booted){delay(10);} //core0 owns the display until setup() is done
+}
+
+void loop1()
+{
+  renderStep();
 }
 
 //----------------------------------------------------------------------------------------------------//
@@ -64,5 +77,5 @@ void setup()
 //----------------------------------------------------------------------------------------------------//
 void loop() {
   //delay(4000);
-  if(checkFlag()){readSensor(false);}
+  contSensor();
 }
@@ -24,6 +24,8 @@ void beginIO()
   
 }
 
+//called from the button timer interrupt: only raises flags, the measurement runs in loop() and core1 draws
+//the text, so nothing here waits on the I2C bus or the display mutex
 void readSensor(bool print)
 {
   if(measuring)
@@ -33,8 +35,37 @@ void readSensor(bool print)
   else
   {
     measuring=true;
-    if(print){bigText(false, "Measuring...");}
-    multimeasure(digitalRead(ENC_BTN));
+    measurerequest=true;
+    if(print){measuringrequest = true;}
+  }
+}
+
+void contSensor()
+{
+  if(measurerequest)
+  {
+    measurerequest=false;
+    if(measuring) //not cancelled by a second press in the meantime
+    {
+      if(sensemode > 1){startBurst(sensemode);} //runs from loop(), a second press stops it
+      else{multimeasure(digitalRead(ENC_BTN));}
+    }
+  }
+  else if(cont_flag)
+  {
+    measuring=true;
+    contmeasure(digitalRead(ENC_BTN));
+  }
+  else if(burstleft)
+  {
+    if(measuring){burstmeasure(digitalRead(ENC_BTN));}
+    else{stopBurst();} //button pressed again mid-burst
+  }
+  else if(measuring)
+  {
+    //continuous mode was switched off mid-integration
+    abortMeasure();
+    measuring=false;
   }
 }
 
@@ -60,13 +91,12 @@ bool buttonBuffer(struct repeating_timer *t)
   //read one time, then toggle the continuous flag if in continuous mode
   if(!digitalRead(BTN_PIN))
   {
-    if(sensemode)
+    if(sensemode == 1)
     {
       cont_flag = !cont_flag;
       cont_flag_draw = cont_flag;
       if(!cont_flag){
-        if(sensecon == 2){drawMain(false, detectColour10(), intreadings);}
-        else{drawMain(false, detectColour18(), intreadings);}
+        redrawrequest = true;
         return true;
       }
     }
@@ -101,16 +131,19 @@ bool encoderBuffer(struct repeating_timer *t)
   }
   else
   {
-    sensemode = !sensemode;
-    if(!sensemode){cont_flag=false;cont_flag_draw = cont_flag;}
+    //single -> continuous -> continuous waterfall -> bursts of increasing length -> single
+    if(sensemode == 1 && !waterfall){waterfall = true;} //same mode, keeps running if it was
+    else{
+      waterfall = false;
+      uint8_t i = 0;
+      while(i < sizeof(sensemodes) && sensemodes[i] != sensemode){i++;}
+      i++;
+      sensemode = sensemodes[(i < sizeof(sensemodes)) ? i : 0];
+      if(sensemode != 1){cont_flag=false;cont_flag_draw = cont_flag;}
+    }
   }
   
-  if(sensecon == 2){
-    drawMain(false, detectColour10(), intreadings);
-  }
-  else{
-    drawMain(false, detectColour18(), intreadings);
-  }
+  redrawrequest = true; //core1 redraws with the new modes
 
   //re-enable int & disable buffer
   attachInterrupt(digitalPinToInterrupt(ENC_PIN_A), encoderInterrupt, CHANGE);
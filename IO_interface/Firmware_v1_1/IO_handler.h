@@ -18,6 +18,10 @@ static const uint8_t ENC_PIN_B = 5;
 static const uint8_t ENC_BTN   = 4;
 
 static volatile bool cont_flag = false;
+static volatile bool measurerequest = false; //set by the button interrupt, loop() starts the reading
+
+//sensemodes the encoder steps through: single fire, continuous, then bursts of that many shots
+static const uint8_t sensemodes[] = {0, 1, 4, 16, 64, 200};
 
 //----------------------------------------------------------------------------------------------------//
 // FUNCTIONS
@@ -25,6 +29,7 @@ static volatile bool cont_flag = false;
 void beginIO();
 
 void readSensor(bool print);
+void contSensor();
 bool checkFlag();
 
 bool buttonBuffer(struct repeating_timer *t);
@@ -0,0 +1,123 @@
+#include "as7265x_bulk.h"
+
+/*
+Registers and Constants
+*/
+static const uint8_t AS7265X_ADDR = 0x49;
+static const uint8_t STATUS_REG = 0x00;
+static const uint8_t WRITE_REG = 0x01;
+static const uint8_t READ_REG = 0x02;
+static const uint8_t TX_VALID = 0x02;
+static const uint8_t RX_VALID = 0x01;
+
+static const uint8_t DEV_SELECT_CONTROL = 0x4F; //virtual register
+static const uint8_t CAL_BLOCK = 0x14; //first calibrated byte (R_G_A_CAL), 6 floats MSB first
+static const uint8_t DEV_NIR = 0x00; //AS72651
+static const uint8_t DEV_VISIBLE = 0x01; //AS72652
+static const uint8_t DEV_UV = 0x02; //AS72653
+
+static const unsigned long POLL_TIMEOUT = 100000; //us of status polling before giving up
+
+uint16_t bulki2ccount = 0;
+unsigned long bulki2ctime = 0;
+
+//where each device's 6 calibrated floats go on screen (410nm = 0 ... 940nm = 17)
+static const uint8_t devOrder[3] = {DEV_UV, DEV_VISIBLE, DEV_NIR};
+static const uint8_t screenIndex[3][6] = {
+  {0, 1, 2, 3, 4, 5},     //UV: A,B,C,D,E,F
+  {6, 7, 9, 11, 16, 17},  //Visible: G,H,I,J,K,L
+  {8, 10, 12, 13, 14, 15} //NIR: R,S,T,U,V,W
+};
+
+/*
+Physical Register Access
+*/
+static uint8_t readReg(uint8_t reg){
+  Wire.beginTransmission(AS7265X_ADDR);
+  Wire.write(reg);
+  Wire.endTransmission(false); //repeated start, counted with the read below
+  Wire.requestFrom(AS7265X_ADDR, (uint8_t)1);
+  bulki2ccount++;
+  if(Wire.available()){return Wire.read();}
+  return 0xFF;
+}
+
+static void writeReg(uint8_t reg, uint8_t val){
+  Wire.beginTransmission(AS7265X_ADDR);
+  Wire.write(reg);
+  Wire.write(val);
+  Wire.endTransmission();
+  bulki2ccount++;
+}
+
+//waits until (status & mask) == want, without the library's 5ms sleep per poll.
+//Bounded by time, not poll count: each poll is a bus transaction (~0.3ms at 100kHz) on top of the 50us wait
+static bool waitStatus(uint8_t mask, uint8_t want){
+  unsigned long start = micros();
+  do{
+    if((readReg(STATUS_REG) & mask) == want) return true;
+    delayMicroseconds(50);
+  } while(micros() - start < POLL_TIMEOUT);
+  return false;
+}
+
+/*
+Virtual Register Access
+*/
+static bool virtualWrite(uint8_t addr, uint8_t val){
+  if(!waitStatus(TX_VALID, 0)) return false;
+  writeReg(WRITE_REG, addr | 0x80);
+  if(!waitStatus(TX_VALID, 0)) return false;
+  writeReg(WRITE_REG, val);
+  return true;
+}
+
+//the slave only raises RX_VALID after it has consumed our address byte, so once the previous read
+//has been collected the write buffer is known to be empty and the TX_VALID check can be skipped
+static bool virtualReadNext(uint8_t addr, uint8_t *val){
+  writeReg(WRITE_REG, addr);
+  if(!waitStatus(RX_VALID, RX_VALID)) return false;
+  *val = readReg(READ_REG);
+  return true;
+}
+
+//reads len consecutive virtual registers from the currently selected device
+static bool virtualReadBlock(uint8_t addr, uint8_t *buf, uint8_t len){
+  if(readReg(STATUS_REG) & RX_VALID){readReg(READ_REG);} //drop any stale byte
+  if(!waitStatus(TX_VALID, 0)) return false;
+  for(uint8_t i = 0; i < len; i++){
+    if(!virtualReadNext(addr + i, &buf[i])) return false;
+  }
+  return true;
+}
+
+/*
+Calibrated Readout
+*/
+bool readCalibrated18(float *readings){
+  unsigned long start = micros();
+  bulki2ccount = 0;
+  uint8_t block[24];
+  bool ok = true;
+
+  for(uint8_t d = 0; d < 3 && ok; d++){
+    ok = virtualWrite(DEV_SELECT_CONTROL, devOrder[d]) && virtualReadBlock(CAL_BLOCK, block, 24);
+    for(uint8_t c = 0; c < 6 && ok; c++){
+      uint32_t bits = ((uint32_t)block[c*4] << 24) | ((uint32_t)block[c*4+1] << 16) | ((uint32_t)block[c*4+2] << 8) | block[c*4+3];
+      float value;
+      memcpy(&value, &bits, sizeof(value)); //IEEE754, same as AS7265X::convertBytesToFloat()
+      readings[screenIndex[d][c]] = value;
+    }
+  }
+  virtualWrite(DEV_SELECT_CONTROL, DEV_NIR); //leave the master (NIR) device selected
+
+  bulki2ctime = micros() - start;
+#if AS7265X_BULK_STATS
+  Serial.print("AS7265x bulk read: ");
+  Serial.print(bulki2ccount);
+  Serial.print(" transactions, ");
+  Serial.print(bulki2ctime);
+  Serial.println("us");
+#endif
+  return ok;
+}
@@ -0,0 +1,22 @@
+#ifndef _AS7265X_BULK_H
+#define _AS7265X_BULK_H
+
+#include <Arduino.h>
+#include <Wire.h> //I2C
+
+/*
+Bulk readout of the AS7265x calibrated channels. The SparkFun getCalibratedX() calls select the
+device and re-check the status register for every channel, with a 5ms sleep on every busy poll.
+This reads each device's 24 byte calibrated block (6 floats at virtual 0x14-0x2B) after a single
+device select, so a frame costs 3 selects and 72 virtual reads instead of 18 and 72+.
+*/
+#define AS7265X_BULK_STATS 0 //1 prints the I2C transaction count and time of every readout over Serial
+
+//I2C transactions (address + data phases) and time used by the last readCalibrated18()
+extern uint16_t bulki2ccount;
+extern unsigned long bulki2ctime; //us
+
+//reads all 18 calibrated channels into readings (screen order, 410nm-940nm), false on bus timeout
+bool readCalibrated18(float *readings);
+
+#endif
@@ -0,0 +1,89 @@
+#include "as7341_autoexposure.h"
+
+static const uint32_t FULL_SCALE = 65535; //16 bit ADC
+static const uint16_t ASTEP_MAX = 65534;
+
+//gain as a multiple of 0.5x
+static uint16_t gainUnits(uint8_t gain){
+  return 1 << gain;
+}
+
+AS7341AutoExposure::AS7341AutoExposure(AS7341Driver &sensor)
+  : _sensor(sensor), _gain(AS7341_GAIN_32X), _steps(AE_MIN_STEPS), _converged(false) {}
+
+void AS7341AutoExposure::begin(){
+  apply();
+}
+
+void AS7341AutoExposure::reset(){
+  _gain = AS7341_GAIN_32X;
+  _steps = AE_MIN_STEPS;
+  _converged = false;
+  apply();
+}
+
+//splits a step count over ATIME and ASTEP, (ATIME+1)*(ASTEP+1) steps of 2.78us
+static uint8_t atimeFor(uint32_t steps){
+  return (steps - 1) / (ASTEP_MAX + 1);
+}
+
+//nearest step count the sensor can do
+static uint32_t quantise(uint32_t steps){
+  uint32_t atime = atimeFor(steps);
+  return (atime + 1) * (steps / (atime + 1));
+}
+
+void AS7341AutoExposure::apply(){
+  uint8_t atime = atimeFor(_steps);
+  uint16_t astep = _steps / (atime + 1) - 1;
+  _sensor.setATIME(atime);
+  _sensor.setASTEP(astep);
+  _sensor.setGain(_gain);
+}
+
+bool AS7341AutoExposure::update(const uint16_t *readings, uint8_t count, bool saturated){
+  if(!enabled) return false;
+
+  uint16_t peak = 0;
+  for(uint8_t i = 0; i < count; i++){
+    if(readings[i] > peak){peak = readings[i];}
+  }
+  uint32_t fullscale = (_steps < FULL_SCALE) ? _steps : FULL_SCALE;
+  float fill = (float)peak / fullscale;
+
+  uint8_t gain = _gain;
+  uint32_t steps = _steps;
+  if(saturated || fill > 0.98f){ //clipped, only the direction is known
+    if(steps > FULL_SCALE){steps = FULL_SCALE;} //counts past full scale first
+    else{gain = (gain > 3) ? gain - 3 : 0;}
+  }
+  else if(fill >= AE_TARGET_LOW && fill <= AE_TARGET_HIGH){
+    _converged = true;
+    return false;
+  }
+  else if(peak == 0){ //no light at all, nothing to scale from
+    if(gain < AS7341_GAIN_512X){gain = (gain + 3 < AS7341_GAIN_512X) ? gain + 3 : AS7341_GAIN_512X;}
+    else{steps *= 4;}
+  }
+  else{
+    float rate = (float)peak / ((float)gainUnits(gain) * steps); //counts per step at 0.5x
+    //lowest gain that reaches the window at the shortest integration
+    for(gain = AS7341_GAIN_0_5X; gain < AS7341_GAIN_512X; gain++){
+      if(rate * gainUnits(gain) >= AE_TARGET_LOW) break;
+    }
+    steps = AE_MIN_STEPS;
+    if(rate * gainUnits(gain) < AE_TARGET_LOW){ //too dim at the highest gain, stretch past full scale
+      steps = AE_TARGET * FULL_SCALE / (rate * gainUnits(gain));
+    }
+  }
+  if(steps < AE_MIN_STEPS){steps = AE_MIN_STEPS;}
+  else if(steps > AE_MAX_STEPS){steps = AE_MAX_STEPS;}
+  steps = quantise(steps);
+
+  _converged = (gain == _gain && steps == _steps); //at a limit, nothing more to do
+  if(_converged) return false;
+  _gain = (as7341_gain_t)gain;
+  _steps = steps;
+  apply();
+  return true;
+}
@@ -0,0 +1,51 @@
+#ifndef _AS7341_AUTOEXPOSURE_H
+#define _AS7341_AUTOEXPOSURE_H
+
+#include <Arduino.h>
+#include "as7341_driver.h"
+
+/*
+Auto-exposure for the AS7341. The ADC full scale is (ATIME+1)*(ASTEP+1) counts (capped at 65535), so
+below 65535 steps the fill of the peak channel only depends on gain, and the integration time only sets
+how many counts that fill is worth. After every frame update() picks the lowest gain that puts the peak
+channel in the target window, at the shortest integration that still gives AE_MIN_STEPS of resolution.
+Only when the highest gain is not enough is the integration stretched past 65535 steps.
+A saturated frame drops the gain 8x at a time (the true level is unknown), any other frame moves straight
+to the new setting, so from any starting point the peak is back in the window within 6 frames.
+The last setting stays in the sensor between shots and is only changed by the next update().
+*/
+#define AE_TARGET_LOW 0.30f //peak channel window, fraction of full scale
+#define AE_TARGET_HIGH 0.80f
+#define AE_TARGET 0.50f //aimed for when the integration has to be stretched
+#define AE_MIN_STEPS 8192UL //shortest integration, ~22.8ms and >= 2400 counts at the bottom of the window
+#define AE_MAX_STEPS 262144UL //longest integration, ~730ms, only used at the highest gain
+
+class AS7341AutoExposure {
+public:
+  AS7341AutoExposure(AS7341Driver &sensor);
+
+  //writes the remembered (or default) setting to the sensor
+  void begin();
+  //forgets the last setting and starts again from the default
+  void reset();
+
+  //call once per finished frame (readings in getAllChannels() order), sets up the next integration
+  //returns true if the setting was changed
+  bool update(const uint16_t *readings, uint8_t count, bool saturated);
+
+  bool converged(){return _converged;}
+  uint32_t steps(){return _steps;} //integration in 2.78us steps
+  as7341_gain_t gain(){return _gain;}
+
+  bool enabled = true; //false leaves the sensor settings alone
+
+private:
+  void apply();
+
+  AS7341Driver &_sensor;
+  as7341_gain_t _gain;
+  uint32_t _steps;
+  bool _converged;
+};
+
+#endif
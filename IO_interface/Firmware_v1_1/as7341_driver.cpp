@@ -0,0 +1,244 @@
+#include "as7341_driver.h"
+
+/*
+Registers and Constants
+*/
+static const uint8_t REG_CONFIG = 0x70; //low bank
+static const uint8_t REG_LED = 0x74; //low bank
+static const uint8_t REG_ENABLE = 0x80;
+static const uint8_t REG_ATIME = 0x81;
+static const uint8_t REG_ID = 0x92;
+static const uint8_t REG_STATUS = 0x93;
+static const uint8_t REG_ASTATUS = 0x94; //reading it latches the 12 data bytes that follow
+static const uint8_t REG_CFG0 = 0xA9;
+static const uint8_t REG_CFG1 = 0xAA;
+static const uint8_t REG_CFG6 = 0xAF;
+static const uint8_t REG_CFG9 = 0xB2;
+static const uint8_t REG_PERS = 0xBD;
+static const uint8_t REG_ASTEP_L = 0xCA;
+static const uint8_t REG_INTENAB = 0xF9;
+
+static const uint8_t ENABLE_PON = 0x01;
+static const uint8_t ENABLE_SP_EN = 0x02;
+static const uint8_t ENABLE_SMUXEN = 0x10;
+static const uint8_t STATUS_SINT = 0x01; //system interrupt (SMUX finished)
+static const uint8_t STATUS_AINT = 0x08; //spectral interrupt (AVALID)
+static const uint8_t ASTATUS_ASAT = 0x80;
+static const uint8_t CHIP_ID = 0x09;
+
+static const unsigned long INT_TIMEOUT = 3000; //ms, blocking read only
+
+//SMUX Configuration for F1,F2,F3,F4,CLEAR,NIR (F1F4_Clear_NIR() in the XWing example)
+static const uint8_t smuxLow[20] = {
+  0x30, 0x01, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x50, 0x00,
+  0x00, 0x00, 0x20, 0x04, 0x00, 0x30, 0x01, 0x50, 0x00, 0x06
+};
+//SMUX Configuration for F5,F6,F7,F8,CLEAR,NIR (F5F8_Clear_NIR() in the XWing example)
+static const uint8_t smuxHigh[20] = {
+  0x00, 0x00, 0x00, 0x40, 0x02, 0x00, 0x10, 0x03, 0x50, 0x10,
+  0x03, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x50, 0x00, 0x06
+};
+
+volatile bool AS7341Driver::_intFired = false;
+
+AS7341Driver::AS7341Driver(int8_t intPin)
+  : _wire(&Wire), _intPin(intPin), _state(IDLE), _atime(0), _astep(999), _gain(AS7341_GAIN_256X), _led(0), _saturated(false) {}
+
+/*
+Read/Write to I2C Register
+*/
+void AS7341Driver::writeRegister(uint8_t reg, uint8_t val){
+  _wire->beginTransmission(AS7341_ADDR);
+  _wire->write(reg);
+  _wire->write(val);
+  _wire->endTransmission();
+}
+
+uint8_t AS7341Driver::readRegister(uint8_t reg){
+  _wire->beginTransmission(AS7341_ADDR);
+  _wire->write(reg);
+  _wire->endTransmission(false);
+  _wire->requestFrom((uint8_t)AS7341_ADDR, (uint8_t)1);
+  if(_wire->available()){return _wire->read();}
+  return 0xFF; //Error
+}
+
+//registers 0x60-0x74 are only reachable with REG_BANK set
+void AS7341Driver::setBank(bool low){
+  writeRegister(REG_CFG0, low ? 0x10 : 0x00);
+}
+
+/*
+Set-Up
+*/
+void AS7341Driver::onInterrupt(){
+  _intFired = true;
+}
+
+bool AS7341Driver::begin(TwoWire *wire){
+  _wire = wire;
+  if((readRegister(REG_ID) & 0xFC) != (CHIP_ID << 2)) return false;
+
+  writeRegister(REG_ENABLE, ENABLE_PON); //PON, spectral engine off
+  writeRegister(REG_CFG6, 0x10); //SMUX command: write configuration from RAM
+  writeRegister(REG_CFG9, 0x10); //SIEN_SMUX, raise SINT when a SMUX command finishes
+  writeRegister(REG_PERS, 0x00); //AINT on every spectral cycle
+  writeRegister(REG_INTENAB, STATUS_AINT | STATUS_SINT); //SP_IEN + SIEN
+  writeRegister(REG_STATUS, 0xFF); //clear anything left over
+  setATIME(_atime);
+  setASTEP(_astep);
+  setGain(_gain);
+
+  if(_intPin >= 0){
+    pinMode(_intPin, INPUT_PULLUP); //INT is open drain, active low
+    attachInterrupt(digitalPinToInterrupt(_intPin), onInterrupt, FALLING);
+  }
+  _state = IDLE;
+  return true;
+}
+
+void AS7341Driver::setATIME(uint8_t atime){
+  _atime = atime;
+  writeRegister(REG_ATIME, atime);
+}
+
+void AS7341Driver::setASTEP(uint16_t astep){
+  _astep = astep;
+  _wire->beginTransmission(AS7341_ADDR);
+  _wire->write(REG_ASTEP_L);
+  _wire->write(astep & 0xFF); //astep[7:0]
+  _wire->write(astep >> 8); //astep[15:8]
+  _wire->endTransmission();
+}
+
+void AS7341Driver::setGain(as7341_gain_t gain){
+  _gain = gain;
+  writeRegister(REG_CFG1, gain);
+}
+
+void AS7341Driver::setLEDCurrent(uint16_t mA){
+  if(mA < 4){mA = 4;}
+  else if(mA > 258){mA = 258;}
+  _led = (_led & 0x80) | ((mA - 4) / 2);
+  setBank(true);
+  writeRegister(REG_LED, _led);
+  setBank(false);
+}
+
+void AS7341Driver::enableLED(bool on){
+  _led = on ? (_led | 0x80) : (_led & 0x7F);
+  setBank(true);
+  writeRegister(REG_CONFIG, 0x08); //LED_SEL, LDR pin driven by the LED register
+  writeRegister(REG_LED, _led);
+  setBank(false);
+}
+
+/*
+Measurement
+*/
+//SMUX RAM auto-increments, so the 20 byte chain goes out in one transaction
+void AS7341Driver::writeSmux(const uint8_t *config){
+  _wire->beginTransmission(AS7341_ADDR);
+  _wire->write((uint8_t)0x00);
+  _wire->write(config, 20);
+  _wire->endTransmission();
+}
+
+//stops the spectral engine, loads a SMUX chain and starts the SMUX command (finishes with SINT)
+void AS7341Driver::startSmux(const uint8_t *config){
+  writeRegister(REG_ENABLE, ENABLE_PON);
+  writeSmux(config);
+  writeRegister(REG_STATUS, 0xFF);
+  _intFired = false;
+  writeRegister(REG_ENABLE, ENABLE_PON | ENABLE_SMUXEN);
+}
+
+//true (and clears it) once the given STATUS interrupt has fired, only touches the bus after an INT edge
+bool AS7341Driver::interruptPending(uint8_t mask){
+  if(_intPin >= 0 && !_intFired && digitalRead(_intPin) == HIGH) return false;
+  uint8_t status = readRegister(REG_STATUS);
+  if(!(status & mask)) return false;
+  _intFired = false;
+  writeRegister(REG_STATUS, status); //write-1-to-clear, releases INT
+  return true;
+}
+
+//ASTATUS + 6 ADC channels in one 13 byte read
+void AS7341Driver::readHalf(uint16_t *dest){
+  uint8_t buf[13];
+  _wire->beginTransmission(AS7341_ADDR);
+  _wire->write(REG_ASTATUS);
+  _wire->endTransmission(false);
+  _wire->requestFrom((uint8_t)AS7341_ADDR, (uint8_t)13);
+  for(uint8_t i = 0; i < 13; i++){
+    buf[i] = _wire->available() ? _wire->read() : 0;
+  }
+  if(buf[0] & ASTATUS_ASAT){_saturated = true;}
+  for(uint8_t i = 0; i < 6; i++){
+    dest[i] = buf[1 + i*2] | (buf[2 + i*2] << 8);
+  }
+}
+
+void AS7341Driver::start(){
+  _saturated = false;
+  startSmux(smuxLow);
+  _state = SMUX_LOW;
+}
+
+bool AS7341Driver::poll(){
+  switch(_state){
+    case SMUX_LOW:
+    case SMUX_HIGH:
+      if(!interruptPending(STATUS_SINT)) return false;
+      writeRegister(REG_ENABLE, ENABLE_PON | ENABLE_SP_EN);
+      _state = (_state == SMUX_LOW) ? INTEG_LOW : INTEG_HIGH;
+      return false;
+    case INTEG_LOW:
+      if(!interruptPending(STATUS_AINT)) return false;
+      readHalf(_low);
+      startSmux(smuxHigh); //second configuration straight away, no PON/config rewrite
+      _state = SMUX_HIGH;
+      return false;
+    case INTEG_HIGH:
+      if(!interruptPending(STATUS_AINT)) return false;
+      readHalf(_high);
+      writeRegister(REG_ENABLE, ENABLE_PON); //stop integrating until the next start()
+      _state = DONE;
+      return true;
+    case DONE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void AS7341Driver::abort(){
+  if(_state == IDLE) return;
+  writeRegister(REG_ENABLE, ENABLE_PON);
+  writeRegister(REG_STATUS, 0xFF);
+  _state = IDLE;
+}
+
+void AS7341Driver::getAllChannels(uint16_t *readings){
+  for(uint8_t i = 0; i < 4; i++){
+    readings[i] = _low[i]; //F1-F4
+    readings[i+4] = _high[i]; //F5-F8
+  }
+  readings[8] = _low[5]; //NIR
+  readings[9] = _low[4]; //CLR
+  _state = IDLE;
+}
+
+bool AS7341Driver::readAllChannels(uint16_t *readings){
+  start();
+  unsigned long t0 = millis();
+  while(!poll()){
+    if(millis() - t0 > INT_TIMEOUT){
+      abort();
+      return false;
+    }
+    yield();
+  }
+  getAllChannels(readings);
+  return true;
+}
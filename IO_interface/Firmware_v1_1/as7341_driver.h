@@ -0,0 +1,87 @@
+#ifndef _AS7341_DRIVER_H
+#define _AS7341_DRIVER_H
+
+#include <Arduino.h>
+#include <Wire.h> //I2C
+
+/*
+Register-level AS7341 driver, built from the ams XWing Hello World flow (AS7341-dev/XWing_Arduino-HelloWorld).
+Power-on, integration time, gain and interrupt setup are written once in begin()/set*(). A measurement
+then runs both SMUX configurations (F1-F4 and F5-F8, each with Clear and NIR) back to back, and waits
+on the sensor INT pin for SMUX completion and AVALID instead of polling ENABLE/STATUS2 over I2C.
+*/
+#define AS7341_ADDR 0x39
+#define AS7341_INT_PIN 6 //SENSOR-INT on the embedded board (GPIO6)
+
+//spectral gain, written to CFG1 (0xAA) AGAIN[4:0]
+typedef enum {
+  AS7341_GAIN_0_5X,
+  AS7341_GAIN_1X,
+  AS7341_GAIN_2X,
+  AS7341_GAIN_4X,
+  AS7341_GAIN_8X,
+  AS7341_GAIN_16X,
+  AS7341_GAIN_32X,
+  AS7341_GAIN_64X,
+  AS7341_GAIN_128X,
+  AS7341_GAIN_256X,
+  AS7341_GAIN_512X,
+} as7341_gain_t;
+
+class AS7341Driver {
+public:
+  //intPin < 0 falls back to polling the STATUS register over I2C
+  AS7341Driver(int8_t intPin = AS7341_INT_PIN);
+
+  //checks the chip ID, powers on and configures the interrupts, returns false if no AS7341 answers
+  bool begin(TwoWire *wire = &Wire);
+
+  //integration time = (ATIME + 1) * (ASTEP + 1) * 2.78us
+  void setATIME(uint8_t atime);
+  void setASTEP(uint16_t astep);
+  void setGain(as7341_gain_t gain);
+  uint8_t getATIME(){return _atime;}
+  uint16_t getASTEP(){return _astep;}
+  as7341_gain_t getGain(){return _gain;}
+
+  //LED driver on the LDR pin, 4-258mA in 2mA steps
+  void setLEDCurrent(uint16_t mA);
+  void enableLED(bool on);
+
+  //non-blocking measurement: start() then call poll() until it returns true, then getAllChannels()
+  void start();
+  bool poll();
+  void abort();
+  void getAllChannels(uint16_t *readings); //F1,F2,F3,F4,F5,F6,F7,F8,NIR,CLR
+  bool saturated(){return _saturated;} //ASAT was set in either half of the last measurement
+
+  //blocking measurement, same channel order as getAllChannels()
+  bool readAllChannels(uint16_t *readings);
+
+private:
+  enum State : uint8_t {IDLE, SMUX_LOW, INTEG_LOW, SMUX_HIGH, INTEG_HIGH, DONE};
+
+  void writeRegister(uint8_t reg, uint8_t val);
+  uint8_t readRegister(uint8_t reg);
+  void writeSmux(const uint8_t *config);
+  void startSmux(const uint8_t *config);
+  void readHalf(uint16_t *dest);
+  bool interruptPending(uint8_t mask);
+  void setBank(bool low);
+
+  static void onInterrupt();
+  static volatile bool _intFired;
+
+  TwoWire *_wire;
+  int8_t _intPin;
+  volatile State _state;
+  uint8_t _atime;
+  uint16_t _astep;
+  as7341_gain_t _gain;
+  uint8_t _led;
+  bool _saturated;
+  uint16_t _low[6]; //F1,F2,F3,F4,CLR,NIR
+  uint16_t _high[6]; //F5,F6,F7,F8,CLR,NIR
+};
+
+#endif
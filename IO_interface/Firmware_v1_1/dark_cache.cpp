@@ -0,0 +1,53 @@
+#include "dark_cache.h"
+
+DarkCache::Entry* DarkCache::find(const SpectralFrame &settings){
+  for(uint8_t i = 0; i < DARK_CACHE_SIZE; i++){
+    Entry &e = _entries[i];
+    if(e.valid && e.sensor == settings.sensor && e.ledmode == settings.ledmode &&
+       e.gain == settings.gain && e.integration == settings.integration){
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+bool DarkCache::needsDark(const SpectralFrame &settings){
+  Entry *e = find(settings);
+  return !e || millis() - e->captured > DARK_MAX_AGE;
+}
+
+void DarkCache::store(const SpectralFrame &dark){
+  Entry *e = find(dark);
+  if(!e){ //free slot, or the least recently used one
+    e = &_entries[0];
+    for(uint8_t i = 0; i < DARK_CACHE_SIZE && e->valid; i++){
+      if(!_entries[i].valid || millis() - _entries[i].used > millis() - e->used){e = &_entries[i];}
+    }
+  }
+  e->valid = true;
+  e->sensor = dark.sensor;
+  e->ledmode = dark.ledmode;
+  e->gain = dark.gain;
+  e->integration = dark.integration;
+  e->captured = dark.timestamp;
+  e->used = dark.timestamp;
+  for(uint8_t i = 0; i < dark.channels; i++){
+    e->values[i] = dark.values[i];
+  }
+}
+
+bool DarkCache::subtract(SpectralFrame &frame){
+  Entry *e = find(frame);
+  if(!e) return false;
+  e->used = millis();
+  for(uint8_t i = 0; i < frame.channels; i++){
+    frame.values[i] = q16SubSat(frame.values[i], e->values[i]);
+  }
+  return true;
+}
+
+void DarkCache::clear(){
+  for(uint8_t i = 0; i < DARK_CACHE_SIZE; i++){
+    _entries[i].valid = false;
+  }
+}
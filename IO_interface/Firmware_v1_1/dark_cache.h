@@ -0,0 +1,49 @@
+#ifndef _DARK_CACHE_H
+#define _DARK_CACHE_H
+
+#include <Arduino.h>
+#include "spectral_frame.h"
+
+/*
+Dark frames (same sensor settings, LEDs off) cached per exposure setting. The key is the sensor, gain,
+integration time and LED mode a frame was taken with, so a dark frame is only ever subtracted from
+frames taken the same way. The acquisition path asks needsDark() before every integration and runs a
+dark one instead when the entry is missing or older than DARK_MAX_AGE, so dark captures happen once per
+setting in the background rather than before every sample. The least recently used entry is replaced
+when the cache is full.
+*/
+#define DARK_CACHE_SIZE 4 //exposure settings remembered (the AS7341 auto-exposure settles on one or two)
+#define DARK_MAX_AGE 120000UL //ms before a dark frame is re-captured (sensor offset drifts with temperature)
+
+class DarkCache {
+public:
+  //true if frames taken with these settings have no fresh dark frame
+  bool needsDark(const SpectralFrame &settings);
+
+  //stores a frame taken with the LEDs off, replacing any older one with the same settings
+  void store(const SpectralFrame &dark);
+
+  //subtracts the matching dark frame (clamped at 0), false if none is cached
+  bool subtract(SpectralFrame &frame);
+
+  //forgets every dark frame, e.g. after the sensor has been covered/uncovered
+  void clear();
+
+private:
+  struct Entry {
+    bool valid;
+    uint8_t sensor;
+    uint8_t ledmode;
+    uint8_t gain;
+    uint32_t integration;
+    unsigned long captured; //millis()
+    unsigned long used; //millis(), for LRU replacement
+    q16_t values[MAX_CHANNELS];
+  };
+
+  Entry* find(const SpectralFrame &settings);
+
+  Entry _entries[DARK_CACHE_SIZE] = {};
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef _FIXEDPOINT_H
+#define _FIXEDPOINT_H
+
+#include <Arduino.h>
+#include <string.h>
+
+/*
+Q16.16 fixed-point helpers for the processing path. Readings become Q16.16 once, where they are read
+(q16FromFloat for the AS7265x calibrated floats, a shift for AS7341 counts), and from there on normalise,
+colour, ripeness, the burst statistics and the dark cache are integer-only. The RP2040 has no FPU; 32 bit
+integer divides go to the SIO hardware divider. Everything here stays within 32 bits so no 64 bit divide
+is ever pulled in. Ratios are Q16.16 rather than Q1.15 because the channel at the maximum has a ratio of
+exactly 1.0. Set FIXEDPOINT_CYCLES in spectroscopico.h to time this against float on the device.
+*/
+typedef uint32_t q16_t; //unsigned Q16.16, 0 to 65535.99998
+
+#define Q16_ONE (1UL << 16)
+#define Q16_FROM_FLOAT(f) ((q16_t)((f) * 65536.0f + 0.5f)) //for constants, folded at compile time
+
+//num/den as Q16.16, num and den < 65536. den = 0 returns Q16_ONE * 65535 (saturated)
+static inline q16_t q16Ratio(uint16_t num, uint16_t den){
+  if(den == 0) return (q16_t)0xFFFFFFFF;
+  return ((uint32_t)num << 16) / den;
+}
+
+//q * n, truncated to an integer. q * n must fit in 32 bits (fine for ratios up to 1.0 and n < 65536)
+static inline uint32_t q16Scale(q16_t q, uint16_t n){
+  return (q * n) >> 16;
+}
+
+static inline q16_t q16Clamp(q16_t q, q16_t lo, q16_t hi){
+  return (q < lo) ? lo : (q > hi) ? hi : q;
+}
+
+//a - b, clamped at 0
+static inline q16_t q16SubSat(q16_t a, q16_t b){
+  return (a > b) ? a - b : 0;
+}
+
+//a float as Q16.16, truncated, from its IEEE754 bits so no float arithmetic runs. Negative values
+//and anything below 2^-16 give 0, 65536 and above (and inf/NaN) saturate
+static inline q16_t q16FromFloat(float f){
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  if(bits & 0x80000000) return 0;
+  int e = (int)((bits >> 23) & 0xFF) - 127;
+  if(e >= 16) return (q16_t)0xFFFFFFFF;
+  if(e < -16) return 0;
+  uint32_t m = (bits & 0x7FFFFF) | 0x800000; //value = m * 2^(e - 23)
+  int shift = e - 7; //Q16.16 = m * 2^(e - 23 + 16)
+  return (shift >= 0) ? m << shift : m >> -shift;
+}
+
+//prints q with two decimals (truncated), in place of Serial.print(float)
+static inline void q16Print(Print &out, q16_t q){
+  uint32_t hundredths = ((q & 0xFFFF) * 100) >> 16;
+  out.print(q >> 16);
+  out.print(hundredths < 10 ? ".0" : ".");
+  out.print(hundredths);
+}
+
+//shift that brings max > 0 into 16 bit integer range: max * 2^shift is in [32768, 65536)
+static inline int q16Shift(q16_t max){
+  return __builtin_clz(max) - 16;
+}
+
+//v * 2^shift, truncated, v <= the max the shift was made for. Shifts only, no divide
+static inline uint16_t q16Mantissa(q16_t v, int shift){
+  return (shift >= 0) ? v << shift : v >> -shift;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _FRAME_QUEUE_H
+#define _FRAME_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/*
+Lock-free single-producer/single-consumer ring used to hand frames from core0 (acquisition) to core1
+(display). Slots are filled and read in place, so a frame is never copied between the cores.
+The producer only writes head and the consumer only writes tail. Both are single bytes, so plain
+load/store with acquire/release ordering is enough on the Cortex-M0+ (no LDREX/STREX needed).
+*/
+template <typename T, uint8_t N>
+class FrameQueue {
+  static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "N must be a power of two between 2 and 128");
+
+public:
+  //producer: slot to fill in place, nullptr when the queue is full
+  T* claim(){
+    uint8_t h = _head.load(std::memory_order_relaxed);
+    if((uint8_t)(h - _tail.load(std::memory_order_acquire)) == N) return nullptr;
+    return &_slots[h & (N - 1)];
+  }
+
+  //producer: makes the slot returned by claim() visible to the consumer
+  void publish(){
+    _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  //consumer: oldest published slot, nullptr when the queue is empty
+  T* front(){
+    uint8_t t = _tail.load(std::memory_order_relaxed);
+    if(t == _head.load(std::memory_order_acquire)) return nullptr;
+    return &_slots[t & (N - 1)];
+  }
+
+  //consumer: hands the front slot back to the producer
+  void pop(){
+    _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  //number of published slots, exact for the calling side and a lower bound for the other
+  uint8_t size() const {
+    return (uint8_t)(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+  }
+
+private:
+  T _slots[N];
+  std::atomic<uint8_t> _head{0}; //free-running, written by the producer only
+  std::atomic<uint8_t> _tail{0}; //free-running, written by the consumer only
+};
+
+#endif
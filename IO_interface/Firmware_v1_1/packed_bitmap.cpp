@@ -0,0 +1,43 @@
+#include "packed_bitmap.h"
+
+//PackBits: n < 128 is n+1 literal bytes, n > 128 is the next byte 257-n times, 128 is padding
+static const uint8_t* unpackRow(const uint8_t *src, uint8_t *row, uint8_t bytes){
+  uint8_t i = 0;
+  while(i < bytes){
+    uint8_t n = *src++;
+    if(n < 128){
+      for(uint8_t k = 0; k <= n && i < bytes; k++){row[i++] = *src++;}
+    }
+    else if(n > 128){
+      uint8_t v = *src++;
+      for(uint16_t k = 0; k < 257 - n && i < bytes; k++){row[i++] = v;}
+    }
+  }
+  return src;
+}
+
+void drawPackedBitmap(Adafruit_GFX &g, int16_t x, int16_t y, const PackedBitmap &bitmap, uint16_t color){
+  uint8_t bytes = (bitmap.width + 7) / 8;
+  if(bytes > PACKED_MAX_ROW_BYTES){return;}
+  uint8_t row[PACKED_MAX_ROW_BYTES];
+  const uint8_t *src = bitmap.data;
+
+  for(uint16_t j = 0; j < bitmap.height;){
+    uint16_t rows = *src++ + 1; //this row and its repeats
+    src = unpackRow(src, row, bytes);
+    if(j + rows > bitmap.height){rows = bitmap.height - j;}
+
+    //each run of set pixels, as tall as the repeated rows
+    for(uint16_t i = 0; i < bitmap.width;){
+      if(!(row[i / 8] & (0x80 >> (i % 8)))){
+        if(row[i / 8] == 0 && i % 8 == 0){i += 8;} //skip empty bytes whole
+        else{i++;}
+        continue;
+      }
+      uint16_t start = i;
+      while(i < bitmap.width && (row[i / 8] & (0x80 >> (i % 8)))){i++;}
+      g.fillRect(x + start, y + j, i - start, rows, color);
+    }
+    j += rows;
+  }
+}
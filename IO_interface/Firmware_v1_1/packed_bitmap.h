@@ -0,0 +1,26 @@
+#ifndef _PACKED_BITMAP_H
+#define _PACKED_BITMAP_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+/*
+Compressed 1-bit bitmaps (same bit layout as Adafruit drawBitmap: rows padded to whole bytes, MSB first),
+made by tools/pack_bitmaps.py. The UI backgrounds are mostly the same few rows repeated (the bar grid), so
+each distinct run of rows is stored once: a count byte n, then the row PackBits-encoded, drawn n+1 times.
+drawPackedBitmap() decodes one row at a time into a small buffer and draws its set pixels as rectangles
+as tall as the run, so the 245x91 grid is ~600 fillRect() calls instead of 22000 pixel tests, and only
+~550 bytes are read from flash instead of 2821.
+*/
+#define PACKED_MAX_ROW_BYTES 32 //widest bitmap, 256 pixels
+
+struct PackedBitmap {
+  const uint8_t *data;
+  uint16_t width;
+  uint16_t height;
+};
+
+//draws the set pixels in color, the others are left alone (as drawBitmap)
+void drawPackedBitmap(Adafruit_GFX &g, int16_t x, int16_t y, const PackedBitmap &bitmap, uint16_t color);
+
+#endif
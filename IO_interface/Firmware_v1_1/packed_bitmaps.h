@@ -0,0 +1,16 @@
+#ifndef _PACKED_BITMAPS_H
+#define _PACKED_BITMAPS_H
+
+//generated by IO_interface/tools/pack_bitmaps.py from the bitmap headers, edit those and re-run it
+#include "packed_bitmap.h"
+
+const uint8_t base18_data[] = {0x00,0x1e,0xff,0xe7,0xff,0x1f,0xfc,0x7f,0xf1,0xff,0xc7,0xff,0x3f,0xf8,0xff,0xe3,0xff,0x8f,0xfe,0x7f,0xf1,0xff,0xc7,0xff,0x1f,0xfc,0xff,0xe3,0xff,0x8f,0xfe,0x3f,0xf8,0x45,0x1e,0x80,0x24,0x01,0x10,0x04,0x40,0x11,0x00,0x44,0x01,0x20,0x08,0x80,0x22,0x00,0x88,0x02,0x40,0x11,0x00,0x44,0x01,0x10,0x04,0x80,0x22,0x00,0x88,0x02,0x20,0x08,0x00,0x1e,0xff,0xe7,0xff,0x1f,0xfc,0x7f,0xf1,0xff,0xc7,0xff,0x3f,0xf8,0xff,0xe3,0xff,0x8f,0xfe,0x7f,0xf1,0xff,0xc7,0xff,0x1f,0xfc,0xff,0xe3,0xff,0x8f,0xfe,0x3f,0xf8,0x00,0xe2,0x00,0x00,0x1e,0x84,0x84,0x67,0x10,0x88,0x42,0x71,0xc9,0x0e,0xce,0x39,0x10,0xe4,0xe1,0x12,0x09,0x1c,0x22,0x21,0xc9,0xc7,0x62,0x1c,0x88,0x22,0x41,0x11,0x04,0x44,0x12,0x10,0x00,0x1e,0xad,0x45,0x14,0x15,0x14,0x55,0x41,0x1a,0x88,0x28,0x22,0x28,0x8a,0x82,0x35,0x11,0x50,0x45,0x50,0x55,0x01,0x15,0x05,0x14,0x56,0xa2,0xa2,0x8a,0xaa,0x2a,0xa8,0x00,0x1e,0xe5,0x47,0x26,0x1d,0x94,0x72,0x61,0x8a,0x8c,0x4c,0x33,0x28,0xc4,0xc3,0x15,0x19,0xd8,0x62,0x50,0x95,0x82,0x25,0x09,0x94,0x22,0xa1,0x32,0x86,0xaa,0x1b,0xa8,0x00,0x1e,0x25,0x41,0x11,0x05,0x54,0x15,0x10,0x4a,0x82,0x22,0x0a,0xa8,0x2a,0x22,0x95,0x14,0x44,0x55,0x51,0x14,0x44,0x15,0x11,0x54,0x52,0xa2,0xaa,0x82,0xaa,0x08,0xa8,0x00,0x1e,0x24,0x81,0x66,0x04,0x88,0x12,0x61,0x89,0x0c,0xcc,0x31,0x10,0xc4,0xc1,0x12,0x08,0x58,0x22,0x21,0x09,0x84,0x62,0x10,0x88,0x22,0x41,0x11,0x04,0x44,0x10,0x90,0x00,0xe2,0x00,0x01,0x0f,0x80,0x42,0x00,0x00,0x04,0x40,0x00,0x00,0x88,0x00,0x00,0x08,0x80,0x00,0x01,0x10,0xfa,0x00,0x01,0x04,0x40,0xfc,0x00,0x00,0x08,0x00,0x0b,0xff,0xc3,0xff,0xff,0xfc,0x7f,0xff,0xff,0x8f,0xff,0xff,0xf8,0xfe,0xff,0x00,0x1f,0xfa,0xff,0x01,0xfc,0x7f,0xfc,0xff,0x00,0xf8,0x00,0xe2,0x00,0x00,0x0c,0x88,0x80,0x78,0xc0,0x00,0x03,0xc0,0x00,0x00,0x89,0x80,0x00,0x07,0xfc,0x00,0x02,0x0f,0x00,0x08,0xfc,0x00,0x04,0x22,0x73,0xc0,0x00,0x00,0x00,0x0d,0x88,0x00,0x44,0x40,0x00,0x04,0x40,0x00,0x00,0x88,0x80,0x00,0x08,0x80,0xfd,0x00,0x02,0x08,0x80,0x08,0xfc,0x00,0x04,0x22,0x22,0x20,0x00,0x00,0x00,0x0e,0x89,0x80,0x44,0x44,0x40,0x04,0x16,0x58,0x00,0x50,0x88,0x80,0x08,0xac,0x70,0xfe,0x00,0x02,0x08,0x9c,0x68,0xfc,0x00,0x04,0x32,0x22,0x20,0x00,0x00,0x00,0x0e,0x88,0x80,0x78,0x44,0x40,0x04,0x19,0x64,0x00,0x20,0x88,0x80,0x08,0xb2,0x98,0xfe,0x00,0x02,0x0f,0x22,0x98,0xfc,0x00,0x04,0x2a,0x23,0xc0,0x00,0x00,0x00,0x0e,0x88,0x80,0x44,0x44,0x40,0x04,0xd0,0x44,0x00,0x20,0x8a,0x80,0x08,0xa0,0x98,0xfe,0x00,0x02,0x0a,0x3e,0x88,0xfc,0x00,0x04,0x26,0x22,0x80,0x00,0x00,0x00,0x0e,0x50,0x80,0x44,0x44,0xc0,0x04,0x50,0x44,0x00,0x20,0x8a,0x80,0x08,0xa0,0x68,0xfe,0x00,0x02,0x09,0x20,0x98,0xfc,0x00,0x04,0x22,0x22,0x40,0x00,0x00,0x00,0x0e,0x21,0xc0,0x78,0xe3,0x40,0x03,0xd0,0x44,0x00,0x21,0xc5,0x00,0x07,0x20,0x08,0xfe,0x00,0x02,0x08,0x9c,0x68,0xfc,0x00,0x04,0x22,0x72,0x20,0x00,0x00,0x00,0xf3,0x00,0x00,0x70,0xf1,0x00};
+const PackedBitmap base18_packed = {base18_data, 245, 91}; //from 18chanbase.h
+
+const uint8_t base10_data[] = {0x00,0x1e,0xff,0xff,0xf8,0x7f,0xff,0xfc,0x3f,0xff,0xfe,0x1f,0xff,0xff,0x0f,0xff,0xff,0x87,0xff,0xff,0xc3,0xff,0xff,0xe1,0xff,0xff,0xf0,0xff,0xff,0xf8,0x7f,0xff,0xfc,0x45,0x1e,0x80,0x00,0x08,0x40,0x00,0x04,0x20,0x00,0x02,0x10,0x00,0x01,0x08,0x00,0x00,0x84,0x00,0x00,0x42,0x00,0x00,0x21,0x00,0x00,0x10,0x80,0x00,0x08,0x40,0x00,0x04,0x00,0x1e,0xff,0xff,0xf8,0x7f,0xff,0xfc,0x3f,0xff,0xfe,0x1f,0xff,0xff,0x0f,0xff,0xff,0x87,0xff,0xff,0xc3,0xff,0xff,0xe1,0xff,0xff,0xf0,0xff,0xff,0xf8,0x7f,0xff,0xfc,0x00,0xe2,0x00,0x00,0x1e,0x04,0x2e,0x00,0x02,0x23,0x80,0x01,0x08,0x80,0x00,0xe5,0xc0,0x00,0x77,0x70,0x00,0x39,0x10,0x00,0x09,0x88,0x00,0x04,0x44,0x00,0x02,0x42,0x00,0x01,0xa3,0x00,0x00,0x1e,0x05,0x68,0x00,0x02,0xaa,0x00,0x01,0x55,0x40,0x00,0x8d,0x00,0x00,0x44,0x40,0x00,0x22,0xa8,0x00,0x10,0x54,0x00,0x08,0xaa,0x00,0x05,0x55,0x00,0x02,0x22,0x80,0x00,0x1e,0x07,0x2c,0x00,0x03,0xbb,0x00,0x01,0xc9,0x40,0x00,0xc5,0x80,0x00,0x66,0x60,0x00,0x31,0xa8,0x00,0x18,0x94,0x00,0x0c,0x4a,0x00,0x03,0x75,0x00,0x02,0x23,0x00,0x00,0x1e,0x01,0x22,0x00,0x00,0x88,0x80,0x00,0x55,0x40,0x00,0x24,0x40,0x00,0x11,0x10,0x00,0x08,0xa8,0x00,0x14,0x54,0x00,0x0a,0xaa,0x00,0x01,0x15,0x00,0x02,0x22,0x80,0x00,0x1e,0x01,0x2c,0x00,0x00,0x8b,0x00,0x00,0x48,0x80,0x00,0xc5,0x80,0x00,0x66,0x60,0x00,0x31,0x10,0x00,0x09,0x88,0x00,0x04,0x44,0x00,0x02,0x12,0x00,0x01,0xba,0x80,0x01,0x03,0x80,0x00,0x08,0x40,0xfd,0x00,0x01,0x02,0x10,0xfc,0x00,0x0f,0x84,0x00,0x00,0x42,0x00,0x00,0x21,0x00,0x00,0x10,0x80,0x00,0x08,0x40,0x00,0x04,0x00,0x03,0xff,0xff,0xf8,0x7f,0xfd,0xff,0x01,0xfe,0x1f,0xfc,0xff,0x0f,0x87,0xff,0xff,0xc3,0xff,0xff,0xe1,0xff,0xff,0xf0,0xff,0xff,0xf8,0x7f,0xff,0xfc,0x00,0xe2,0x00,0x00,0x01,0x04,0x44,0xfe,0x00,0x01,0xf1,0x80,0xfd,0x00,0x00,0x3c,0xfe,0x00,0x0f,0x01,0x13,0x00,0x00,0x70,0x00,0x00,0x78,0x00,0x40,0x22,0x73,0xc0,0x04,0x41,0x00,0x00,0x01,0x04,0x40,0xfe,0x00,0x01,0x88,0x80,0xfd,0x00,0x00,0x44,0xfe,0x00,0x0f,0x01,0x11,0x00,0x00,0x88,0x00,0x00,0x44,0x00,0x40,0x22,0x22,0x20,0x0a,0x41,0x00,0x00,0x01,0x04,0x4c,0xfe,0x00,0x02,0x88,0x88,0x80,0xfe,0x00,0x13,0x41,0x65,0x80,0x00,0x00,0xa1,0x11,0x00,0x8a,0xc7,0x00,0x44,0xe3,0x40,0x32,0x22,0x20,0x11,0x41,0x00,0x00,0x01,0x04,0x44,0xfe,0x00,0x02,0xf0,0x88,0x80,0xfe,0x00,0x13,0x41,0x96,0x40,0x00,0x00,0x41,0x11,0x00,0x8b,0x29,0x80,0x79,0x14,0xc0,0x2a,0x23,0xc0,0x11,0x41,0x00,0x00,0x01,0x04,0x44,0xfe,0x00,0x02,0x88,0x88,0x80,0xfe,0x00,0x13,0x4d,0x04,0x40,0x00,0x00,0x41,0x15,0x00,0x8a,0x09,0x80,0x51,0xf4,0x40,0x26,0x22,0x80,0x1f,0x41,0x00,0x00,0x01,0x02,0x84,0xfe,0x00,0x02,0x88,0x89,0x80,0xfe,0x00,0x13,0x45,0x04,0x40,0x00,0x00,0x41,0x15,0x00,0x8a,0x06,0x80,0x49,0x04,0xc0,0x22,0x22,0x40,0x11,0x41,0x00,0x00,0x01,0x01,0x0e,0xfe,0x00,0x02,0xf1,0xc6,0x80,0xfe,0x00,0x13,0x3d,0x04,0x40,0x00,0x00,0x43,0x8a,0x00,0x72,0x00,0x80,0x44,0xe3,0x40,0x22,0x72,0x20,0x11,0x7d,0xf0,0x00,0xed,0x00,0x00,0x07,0xf7,0x00};
+const PackedBitmap base10_packed = {base10_data, 246, 90}; //from 10chanbase.h
+
+const uint8_t ripescale_data[] = {0x00,0x02,0x88,0x00,0x08,0xfc,0x00,0x01,0x07,0x84,0xfc,0x00,0x00,0x0e,0xfe,0x00,0x02,0x10,0x00,0x00,0x00,0x00,0x88,0xfa,0x00,0x01,0x04,0x40,0xfc,0x00,0x00,0x11,0xfb,0x00,0x00,0x04,0x8a,0xcb,0x18,0xb1,0xc0,0xfe,0x00,0x03,0x04,0x4c,0x58,0xe0,0xfe,0x00,0x06,0x11,0x44,0xe5,0x96,0x31,0x63,0x80,0x00,0x04,0x8b,0x2c,0x88,0xca,0x20,0xfe,0x00,0x03,0x07,0x84,0x65,0x10,0xfe,0x00,0x06,0x11,0x45,0x16,0x59,0x11,0x94,0x40,0x00,0x04,0x8a,0x28,0x08,0xcb,0xe0,0xfe,0x00,0x03,0x05,0x04,0x65,0xf0,0xfe,0x00,0x06,0x11,0x45,0xf4,0x10,0x11,0x97,0xc0,0x00,0x03,0x8a,0x28,0x08,0xb2,0xfd,0x00,0x02,0x04,0x84,0x59,0xfd,0x00,0x06,0x11,0x29,0x04,0x10,0x11,0x64,0x00,0x00,0x04,0x72,0x28,0x1c,0x81,0xc0,0xfe,0x00,0x03,0x04,0x4e,0x40,0xe0,0xfe,0x00,0x06,0x0e,0x10,0xe4,0x10,0x39,0x03,0x80,0x00,0xfe,0x00,0x00,0x80,0xfb,0x00,0x00,0x40,0xf9,0x00,0x02,0x01,0x00,0x00,0x00,0xeb,0x00,0x01,0x00,0x80,0xf8,0x00,0x00,0x80,0xf9,0x00,0x02,0x02,0x00,0x00,0x01,0x00,0x80,0xfd,0x00,0x00,0x80,0xfd,0x00,0x00,0x80,0xfd,0x00,0x00,0x80,0xfe,0x00,0x02,0x02,0x00,0x00,0x01,0x15,0x80,0x00,0x08,0x00,0x00,0x80,0x00,0x08,0x00,0x00,0x80,0x00,0x08,0x00,0x00,0x80,0x00,0x08,0x00,0x02,0x00,0x00,0x00,0xee,0xff,0x02,0xfe,0x00,0x00};
+const PackedBitmap ripescale_packed = {ripescale_data, 170, 16}; //from ripescale.h
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef _SPECTRAL_FRAME_H
+#define _SPECTRAL_FRAME_H
+
+#include <Arduino.h>
+#include "fixedpoint.h"
+
+#define MAX_CHANNELS 18 //AS7265x, the AS7341 uses the first 10
+
+/*
+One complete reading and the settings it was taken with. Frames live in fixed buffers and are passed
+by reference from acquisition (collectMeasure) through processing (normalise, colour, ripeness) to
+rendering (drawMain), so no stage overwrites data another stage is still using.
+*/
+struct SpectralFrame {
+  uint8_t channels; //18 for AS7265x (and generated data), 10 for AS7341
+  uint8_t sensor; //sensecon at capture (0 = none, 1 = AS7265x, 2 = AS7341)
+  uint8_t ledmode; //ledmode at capture
+  uint8_t gain; //AS7341 AGAIN code or AS7265x gain code
+  uint32_t integration; //integration time, us
+  unsigned long timestamp; //millis() when the frame was collected
+  bool darkcorrected; //a cached dark frame with the same settings was subtracted from values
+  uint16_t shots; //1 for a single reading, the burst length for a burst mean
+  q16_t values[MAX_CHANNELS]; //readings in screen order as Q16.16 (calibrated for AS7265x, counts for AS7341), dark corrected
+  uint8_t bars[MAX_CHANNELS]; //values scaled to 0-69 bar heights for display
+  q16_t spread[MAX_CHANNELS]; //Q16.16 per-channel standard deviation over a burst, only valid when shots > 1
+  uint8_t whiskers[MAX_CHANNELS]; //spread on the same scale as bars, 0 for single readings
+};
+
+#endif
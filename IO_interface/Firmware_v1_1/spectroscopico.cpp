@@ -1,18 +1,28 @@
 #include "spectroscopico.h"
+#include <pico/mutex.h>
 
 /*
 Global Variable Definitions
 */
 int8_t pos = 0;
 int8_t newpos = 0;
-float readings18[18];
-uint16_t readings10[10];
-uint8_t intreadings[18];
-uint8_t intreadingsmem[9][18];
 uint8_t sensecon;
 uint8_t ledmode = 1;
 uint8_t sensemode = 0;
+volatile uint8_t burstleft = 0;
 volatile bool cont_flag_draw = false;
+volatile bool waterfall = false;
+volatile bool booted = false;
+volatile bool redrawrequest = false;
+volatile bool measuringrequest = false;
+uint16_t refreshinterval = 0;
+uint8_t fullrefreshevery = 25;
+uint32_t framesdrawn = 0;
+unsigned long rendertime = 0;
+uint8_t renderpasses = 0;
+uint32_t renderpixels = 0;
+uint32_t renderbytes = 0;
+static unsigned long renderstart = 0;
 volatile bool ledState = LOW;
 volatile bool measuring = false;
 volatile bool buttonpress = false;
@@ -37,59 +47,193 @@ const char* wavelengthNames10[] = {
 /*
 Spectral Sensor Functions
 */
-//spectral reading, ledmode 0 for no LEDs, 1 for inbuilt LEDs, (2 for external LEDs, 4 for all LEDs)
-void measure(){
-  if(sensecon == 1){ //AS7265x 18 channels
-    if(ledmode == 0){ //measure with no LEDs
-      sensor.takeMeasurements();
-    }
-    else if(ledmode == 1){ //measure with inbuilt LEDs
+volatile uint8_t acqstate = ACQ_IDLE;
+static FrameQueue<RenderJob, RENDER_QUEUE_SIZE> renderqueue; //core0 -> core1, the front job is the one on screen
+static RenderJob dropped; //filled instead of a queue slot when the ring is full
+static volatile uint32_t framesfull = 0; //jobs that found the ring full, written by core0 only
+static volatile uint32_t framesskipped = 0; //jobs drained unseen for a newer one, written by core1 only
+auto_init_mutex(displaymutex); //drawing happens on core1, and on core0 during setup()
+static unsigned long acqstart = 0; //millis() when the current integration was started
+static unsigned long acqlastpoll = 0; //millis() of the last data-ready check
+static bool acqdark = false; //the running integration is a dark frame for the cache
+static DarkCache darkcache;
+
+//switches on the LEDs selected by ledmode for the connected sensor
+static void ledsOn(){
+  if(ledmode == 2 || ledmode == 3){digitalWrite(16, HIGH);} //external LEDs
+  if(ledmode == 1 || ledmode == 3){ //inbuilt LEDs
+    if(sensecon == 1){
       sensor.enableBulb(AS7265x_LED_WHITE);
       sensor.enableBulb(AS7265x_LED_IR);
       // sensor.enableBulb(AS7265x_LED_UV);
-      sensor.takeMeasurements();
-      sensor.disableBulb(AS7265x_LED_WHITE);
-      sensor.disableBulb(AS7265x_LED_IR);
-      // sensor.disableBulb(AS7265x_LED_UV);
     }
-    else if(ledmode == 2){ //measure with extenal LEDs
-      digitalWrite(16, HIGH);
-      sensor.takeMeasurements();
-      digitalWrite(16, LOW);
-    }
-    else if(ledmode == 3){ //measure with inbuilt and external LEDs
-      digitalWrite(16, HIGH);
-      sensor.enableBulb(AS7265x_LED_WHITE);
-      sensor.enableBulb(AS7265x_LED_IR);
-      // sensor.enableBulb(AS7265x_LED_UV);
-      sensor.takeMeasurements();
-      sensor.disableBulb(AS7265x_LED_WHITE);
-      sensor.disableBulb(AS7265x_LED_IR);
-      // sensor.disableBulb(AS7265x_LED_UV);
-      digitalWrite(16, LOW);
+    else if(sensecon == 2){as7341.enableLED(true);}
+  }
+}
+
+//switches off every LED, regardless of ledmode (it may have changed mid-integration)
+static void ledsOff(){
+  digitalWrite(16, LOW);
+  if(sensecon == 1){
+    sensor.disableBulb(AS7265x_LED_WHITE);
+    sensor.disableBulb(AS7265x_LED_IR);
+    // sensor.disableBulb(AS7265x_LED_UV);
+  }
+  else if(sensecon == 2){as7341.enableLED(false);}
+}
+
+//scales the readings to 0-69 bar heights for display, integer-only
+void normalise(SpectralFrame &frame){
+  q16_t maxReading = 0;
+  for (int i = 0; i < frame.channels; i++) {
+    if (frame.values[i] > maxReading) maxReading = frame.values[i];
+  }
+  if (maxReading == 0) {
+    memset(frame.bars, 0, frame.channels);
+    return;
+  }
+  int shift = q16Shift(maxReading); //max becomes a 16 bit integer, the rest keep their ratio to it
+  uint16_t max16 = q16Mantissa(maxReading, shift);
+  for (int i = 0; i < frame.channels; i++) {
+    frame.bars[i] = q16Scale(q16Ratio(q16Mantissa(frame.values[i], shift), max16), 69);
+    frame.whiskers[i] = 0;
+    if (frame.shots > 1) {
+      q16_t spread = (frame.spread[i] < maxReading) ? frame.spread[i] : maxReading;
+      frame.whiskers[i] = q16Scale(q16Ratio(q16Mantissa(spread, shift), max16), 69);
     }
-    else{ //measure with no LEDs if invalid mode
-      sensor.takeMeasurements();
+  }
+}
+
+#if FIXEDPOINT_CYCLES
+//the reading conversion and normalise() against the float normalise() they replaced, on the same readings,
+//timed with the SysTick cycle counter
+static volatile uint32_t cyclesink;
+static void fixedPointCycles(const SpectralFrame &frame){
+  float readings[MAX_CHANNELS];
+  for(uint8_t i = 0; i < frame.channels; i++){
+    readings[i] = frame.values[i] / 65536.0f;
+  }
+  SpectralFrame copy = frame;
+  uint32_t start = rp2040.getCycleCount();
+  for(uint8_t i = 0; i < copy.channels; i++){
+    copy.values[i] = q16FromFloat(readings[i]);
+  }
+  normalise(copy);
+  uint32_t fixedcycles = rp2040.getCycleCount() - start;
+  cyclesink += copy.bars[0];
+
+  start = rp2040.getCycleCount();
+  float maxReading = 0;
+  for(uint8_t i = 0; i < copy.channels; i++){
+    if(readings[i] > maxReading) maxReading = readings[i];
+  }
+  for(uint8_t i = 0; i < copy.channels; i++){
+    copy.bars[i] = (maxReading == 0) ? 0 : readings[i] / maxReading * 69;
+  }
+  uint32_t floatcycles = rp2040.getCycleCount() - start;
+  cyclesink += copy.bars[0];
+
+  Serial.print("normalise: ");
+  Serial.print(fixedcycles);
+  Serial.print(" cycles fixed point, ");
+  Serial.print(floatcycles);
+  Serial.println(" float");
+}
+#endif
+
+//fills in the sensor settings the next integration will run with (the dark cache key)
+static void frameSettings(SpectralFrame &frame){
+  frame.sensor = sensecon;
+  frame.ledmode = ledmode;
+  if(sensecon == 1){
+    frame.channels = 18;
+    frame.gain = AS7265X_GAIN_CODE;
+    frame.integration = AS7265X_INTEGRATION;
+  }
+  else if(sensecon == 2){
+    frame.channels = 10;
+    frame.gain = as7341.getGain();
+    frame.integration = ((uint32_t)as7341.getATIME() + 1) * ((uint32_t)as7341.getASTEP() + 1) * 278 / 100;
+  }
+  else{
+    frame.channels = 18;
+    frame.gain = 0;
+    frame.integration = 750000;
+  }
+}
+
+//starts an integration with the LEDs for the current ledmode, returns immediately.
+//If the dark cache has nothing fresh for these settings, a dark integration (LEDs off) runs instead
+void startMeasure(){
+  if(acqstate != ACQ_IDLE) return;
+  static SpectralFrame settings;
+  frameSettings(settings);
+  acqdark = (sensecon != 0 && ledmode != 0 && darkcache.needsDark(settings)); //ledmode 0 is a dark frame already
+  if(!acqdark){ledsOn();}
+  if(sensecon == 1){ //AS7265x 18 channels
+    sensor.setMeasurementMode(AS7265X_MEASUREMENT_MODE_6CHAN_ONE_SHOT); //same as takeMeasurements(), without the wait
+  }
+  else if(sensecon == 2){ //AS7341 10 channels
+    as7341.start(); //F1-F4 SMUX, the F5-F8 half is started by poll()
+  }
+  acqstart = millis();
+  acqlastpoll = acqstart;
+  acqstate = ACQ_INTEGRATING;
+}
+
+//checks whether the running integration has finished, never blocks
+bool pollMeasure(){
+  if(acqstate == ACQ_READY) return true;
+  if(acqstate == ACQ_IDLE) return false;
+
+  unsigned long now = millis();
+  if(now - acqstart > ACQ_TIMEOUT){ //give up and collect whatever the sensor holds (as takeMeasurements() does)
+    acqstate = ACQ_READY;
+    return true;
+  }
+  if(now - acqlastpoll < ACQ_POLL_INTERVAL) return false; //don't hammer the I2C bus
+  acqlastpoll = now;
+
+  bool ready;
+  if(sensecon == 1){ready = sensor.dataAvailable();}
+  else if(sensecon == 2){ready = as7341.poll();} //INT pin, no bus traffic until it fires
+  else{ready = (now - acqstart >= 750);} //simulates integration time
+  if(ready){acqstate = ACQ_READY;}
+  return ready;
+}
+
+//reads out a finished integration into frame and switches the LEDs off.
+//Returns false if it was a dark integration, which goes to the dark cache and leaves nothing to show
+bool collectMeasure(SpectralFrame &frame){
+  if(acqstate == ACQ_IDLE) return false;
+  ledsOff();
+  frameSettings(frame); //before the auto-exposure moves them on
+  frame.timestamp = millis();
+  frame.darkcorrected = false;
+  frame.shots = 1;
+  if(sensecon == 1){ //AS7265x 18 channels
+    float readings18[18];
+    //calibrated, one pass over each device's calibrated block
+    if(!readCalibrated18(readings18)){ //bus timeout, fall back to the per-channel library reads
+      readings18[0] = sensor.getCalibratedA();  // 410nm
+      readings18[1] = sensor.getCalibratedB();  // 435nm
+      readings18[2] = sensor.getCalibratedC();  // 460nm
+      readings18[3] = sensor.getCalibratedD();  // 485nm
+      readings18[4] = sensor.getCalibratedE();  // 510nm
+      readings18[5] = sensor.getCalibratedF();  // 535nm
+      readings18[6] = sensor.getCalibratedG();  // 560nm
+      readings18[7] = sensor.getCalibratedH();  // 585nm
+      readings18[8] = sensor.getCalibratedR();  // 610nm
+      readings18[9] = sensor.getCalibratedI();  // 645nm
+      readings18[10] = sensor.getCalibratedS(); // 680nm
+      readings18[11] = sensor.getCalibratedJ(); // 705nm
+      readings18[12] = sensor.getCalibratedT(); // 730nm
+      readings18[13] = sensor.getCalibratedU(); // 760nm
+      readings18[14] = sensor.getCalibratedV(); // 810nm
+      readings18[15] = sensor.getCalibratedW(); // 860nm
+      readings18[16] = sensor.getCalibratedK(); // 900nm
+      readings18[17] = sensor.getCalibratedL(); // 940nm
     }
-    //calibrated
-    readings18[0] = sensor.getCalibratedA();  // 410nm
-    readings18[1] = sensor.getCalibratedB();  // 435nm
-    readings18[2] = sensor.getCalibratedC();  // 460nm
-    readings18[3] = sensor.getCalibratedD();  // 485nm
-    readings18[4] = sensor.getCalibratedE();  // 510nm
-    readings18[5] = sensor.getCalibratedF();  // 535nm
-    readings18[6] = sensor.getCalibratedG();  // 560nm
-    readings18[7] = sensor.getCalibratedH();  // 585nm
-    readings18[8] = sensor.getCalibratedR();  // 610nm
-    readings18[9] = sensor.getCalibratedI();  // 645nm
-    readings18[10] = sensor.getCalibratedS(); // 680nm
-    readings18[11] = sensor.getCalibratedJ(); // 705nm
-    readings18[12] = sensor.getCalibratedT(); // 730nm
-    readings18[13] = sensor.getCalibratedU(); // 760nm
-    readings18[14] = sensor.getCalibratedV(); // 810nm
-    readings18[15] = sensor.getCalibratedW(); // 860nm
-    readings18[16] = sensor.getCalibratedK(); // 900nm
-    readings18[17] = sensor.getCalibratedL(); // 940nm
     
     //uncalibrated
     // readings18[0] = sensor.getA();  // 410nm
@@ -110,64 +254,156 @@ void measure(){
     // readings18[15] = sensor.getW(); // 860nm
     // readings18[16] = sensor.getK(); // 900nm
     // readings18[17] = sensor.getL(); // 940nm
-    float maxReading = 0;
-    for (int i = 0; i < 18; i++) {
-      if (readings18[i] > maxReading) maxReading = readings18[i];
-    }
-    for (int i = 0; i < 18; i++) {
-      intreadings[i] = readings18[i] / maxReading * 69;
+    for(uint8_t i = 0; i < 18; i++){
+      frame.values[i] = q16FromFloat(readings18[i]); //Q16.16 from here on, no float arithmetic
     }
   }
   else if(sensecon == 2){ //AS7341 10 channels
-    if(ledmode == 0){ //measure with no LEDs
-      as7341.readAllChannels(readings10);
-    }
-    else if(ledmode == 1){ //measure with inbuilt LEDs
-      as7341.enableLED(true);
-      as7341.readAllChannels(readings10);
-      as7341.enableLED(false);
-    }
-    else if(ledmode == 2){ //measure with extenal LEDs
-      digitalWrite(16, HIGH);
-      sensor.takeMeasurements();
-      digitalWrite(16, LOW);
-    }
-    else if(ledmode == 3){ //measure with inbuilt and external LEDs
-      digitalWrite(16, HIGH);
-      as7341.enableLED(true);
-      as7341.readAllChannels(readings10);
-      as7341.enableLED(false);
-      digitalWrite(16, LOW);
-    }
-    else{ //measure with no LEDs if invalid mode
-      as7341.readAllChannels(readings10);
-    }
-    //need to re-order from F1,2,3,4,CLR,NIR,5,6,7,8 to F1,2,3,4,5,6,7,8,NIR,CLR
-    uint16_t CLR = readings10[4];
-    uint16_t NIR = readings10[5];
-    readings10[4] = readings10[6];
-    readings10[5] = readings10[7];
-    readings10[6] = readings10[8];
-    readings10[7] = readings10[9];
-    readings10[8] = NIR;
-    readings10[9] = CLR;
-
-    //scales to 0-68 for display (65535 is largest value for uint16_t)
-    float maxReading = 0;
-    for (int i = 0; i < 10; i++) {
-      if (readings10[i] > maxReading) maxReading = readings10[i];
-    }
-    for (int i = 0; i < 10; i++) {
-      intreadings[i] = readings10[i] / maxReading * 69;
+    uint16_t readings10[10];
+    as7341.getAllChannels(readings10); //already F1,2,3,4,5,6,7,8,NIR,CLR
+    for(uint8_t i = 0; i < 10; i++){
+      frame.values[i] = (q16_t)readings10[i] << 16;
     }
+    if(!acqdark){as7341ae.update(readings10, 10, as7341.saturated());} //settings for the next integration
   }
   else{ //randomly generates bogus data if no sensor connected
     for(uint8_t i = 0; i < 18; i++){ 
-      intreadings[i] = random(68);
-      readings18[i] = intreadings[i];
+      frame.values[i] = (q16_t)random(68) << 16;
     }
-    delay(750); //simulates integration time
   }
+  acqstate = ACQ_IDLE;
+
+  if(acqdark){
+    darkcache.store(frame);
+    acqdark = false;
+    return false;
+  }
+  if(sensecon != 0 && ledmode != 0){frame.darkcorrected = darkcache.subtract(frame);}
+  return true;
+}
+
+//abandons a running integration (e.g. continuous mode stopped), the result is discarded
+void abortMeasure(){
+  if(acqstate == ACQ_IDLE) return;
+  if(sensecon == 2){as7341.abort();}
+  ledsOff();
+  acqdark = false;
+  acqstate = ACQ_IDLE;
+}
+
+//spectral reading, ledmode 0 for no LEDs, 1 for inbuilt LEDs, (2 for external LEDs, 4 for all LEDs)
+void measure(SpectralFrame &frame){
+  abortMeasure(); //a blocking read always starts a fresh integration
+  do{ //an extra integration first if the dark frame for these settings is missing or stale
+    startMeasure();
+    while(!pollMeasure()){
+      yield();
+    }
+  } while(!collectMeasure(frame));
+  normalise(frame);
+}
+
+//slot for the next frame: a queue slot, or the scratch job if the ring is full
+static RenderJob& claimJob(){
+  RenderJob *job = renderqueue.claim();
+  return job ? *job : dropped;
+}
+
+//hands a filled job to core1, a job in the scratch slot is discarded
+static void publishJob(RenderJob &job){
+  if(&job != &dropped){renderqueue.publish();}
+  else{framesfull++;}
+}
+
+//true when results go on the waterfall rather than the bar chart
+static bool waterfallView(){
+  return waterfall && sensemode == 1;
+}
+
+//draws a frame in the screen selected by the encoder button, or on the waterfall in continuous mode
+void drawResult(bool full, bool enc, const SpectralFrame &frame){
+  if(waterfallView()){drawWaterfall(full, frame);}
+  else if(enc){drawMain(full, detectColour(frame), frame);}
+  else{drawMainRipe(full, bananaRipeness(frame), frame);}
+}
+
+//continuous mode step, call repeatedly from loop(). The next integration is started before the finished
+//frame is drawn, so the sensor integrates while the e-paper refreshes instead of after it
+void contmeasure(bool enc){
+  if(acqstate == ACQ_IDLE){
+    startMeasure();
+    return;
+  }
+  if(!pollMeasure()) return;
+
+  RenderJob &job = claimJob();
+  bool shown = collectMeasure(job.frame);
+  startMeasure(); //next integration runs while core1 draws this one
+  if(!shown) return; //dark frame, the slot is refilled by the next one
+  normalise(job.frame);
+#if FIXEDPOINT_CYCLES
+  fixedPointCycles(job.frame);
+#endif
+  job.enc = enc;
+  publishJob(job);
+}
+
+//burst statistics, folded in shot by shot so the burst length is only limited by burstleft
+static Welford<MAX_CHANNELS> burststats;
+static SpectralFrame burstshot;
+
+//arms a burst of shots readings, run by burstmeasure()
+void startBurst(uint8_t shots){
+  abortMeasure();
+  burststats.reset();
+  as7341ae.enabled = false; //every shot of a burst is taken with the same settings
+  burstleft = shots;
+}
+
+//burst mode step, call repeatedly from loop() while burstleft > 0. Draws the mean once the last shot is in
+void burstmeasure(bool enc){
+  if(acqstate == ACQ_IDLE){
+    startMeasure();
+    return;
+  }
+  if(!pollMeasure()) return;
+
+  if(collectMeasure(burstshot)){ //dark frames don't count as shots
+    burststats.add(burstshot.values, burstshot.channels);
+    burstleft--;
+  }
+  if(burstleft){
+    startMeasure();
+    return;
+  }
+  as7341ae.enabled = true;
+
+  RenderJob &job = claimJob();
+  job.frame = burstshot; //settings of the last shot, which all shots share
+  job.frame.shots = burststats.count();
+  Serial.print("Burst of ");
+  Serial.println(job.frame.shots);
+  for(uint8_t i = 0; i < job.frame.channels; i++){
+    job.frame.values[i] = burststats.mean(i);
+    job.frame.spread[i] = burststats.stddev(i);
+    Serial.print(job.frame.channels == 18 ? wavelengthNames18[i] : wavelengthNames10[i]);
+    Serial.print(": ");
+    q16Print(Serial, job.frame.values[i]);
+    Serial.print(" +/- ");
+    q16Print(Serial, job.frame.spread[i]);
+    Serial.println();
+  }
+  normalise(job.frame);
+  job.enc = enc;
+  publishJob(job);
+  measuring = false;
+}
+
+//abandons a burst part way (button pressed again), nothing is drawn
+void stopBurst(){
+  abortMeasure();
+  as7341ae.enabled = true;
+  burstleft = 0;
 }
 
 // spectroscopico.cpp
@@ -176,37 +412,92 @@ void multimeasure(bool enc)
   // Make sure it's not already reading
   if (!measuring) return; 
 
-  //measure and print
-  measure();
-  if(enc){
-    if(sensecon == 2){drawMain(false, detectColour10(), intreadings);}
-    else{drawMain(false, detectColour18(), intreadings);}
-  }
-  else{
-    if(sensecon == 2){drawMainRipe(false, bananaRipeness(), intreadings);}
-    else{drawMainRipe(false, bananaRipeness(), intreadings);}
-  }
+  //measure and hand to core1 for drawing
+  RenderJob &job = claimJob();
+  measure(job.frame);
+  job.enc = enc;
+  publishJob(job);
 
   // Signal that this single measurement is done
   measuring = false;
 
 }
 
+//core1 loop, the display governor: drains the ring down to the newest frame (frames that arrive while the
+//panel refreshes replace each other), draws it once the panel is free, redraws the one on screen when the
+//IO handlers ask for it, keeps to refreshinterval between refreshes and makes every fullrefreshevery-th
+//one a full refresh. The frame on screen stays at the front of the ring so it can be redrawn without a copy
+void renderStep(){
+  static bool frontdrawn = false; //the front job is the one on screen
+  static unsigned long lastrefresh = 0;
+  static uint8_t partials = 0;
+  if(!booted) return;
+
+  while(renderqueue.size() > 1){ //a newer frame is waiting, release the older ones
+    if(!frontdrawn){framesskipped++;}
+    renderqueue.pop();
+    frontdrawn = false;
+  }
+  if(measuringrequest){ //a reading was started from the button, unless its result is already in
+    measuringrequest = false;
+    if(!renderqueue.front() || frontdrawn){
+      bigText(false, "Measuring...");
+      lastrefresh = millis();
+      return;
+    }
+  }
+  if(millis() - lastrefresh < refreshinterval) return;
+
+  RenderJob *job = renderqueue.front();
+  bool fresh = job && !frontdrawn;
+  if(!fresh && !redrawrequest) return;
+  redrawrequest = false; //a new frame is drawn with the current modes anyway
+
+  bool full = false;
+  if(fullrefreshevery && ++partials >= fullrefreshevery){ //clears partial refresh ghosting
+    partials = 0;
+    full = true;
+  }
+
+  if(fresh){
+    drawResult(full, job->enc, job->frame);
+    frontdrawn = true;
+    framesdrawn++;
+  }
+  else{
+    static SpectralFrame empty; //nothing measured yet, empty bars
+    empty.channels = (sensecon == 2) ? 10 : 18;
+    const SpectralFrame &frame = job ? job->frame : empty;
+    if(waterfallView()){drawWaterfall(full, frame);} //same frame again, nothing is added
+    else{drawMain(full, detectColour(frame), frame);}
+  }
+  lastrefresh = millis();
+}
+
+//frames published by acquisition that core1 never drew
+uint32_t framesdropped(){
+  return framesfull + framesskipped;
+}
+
 //determine the dominant colour (based on Sparkfun example)
-String detectColour18() {
+String detectColour(const SpectralFrame &frame) {
+  if(frame.channels == 10){return detectColour10(frame);}
+  return detectColour18(frame);
+}
+String detectColour18(const SpectralFrame &frame) {
   int maxIndex = 0;
-  float maxVal;
+  q16_t maxVal = 0;
   
   // Find the peak wavelength
   for (int i = 1; i < 18; i++) {
-    if (readings18[i] > maxVal) {
-      maxVal = readings18[i];
+    if (frame.values[i] > maxVal) {
+      maxVal = frame.values[i];
       maxIndex = i+1; //number of the column that appears on screen
     }
   }
   
   // Determine dominant colour based on peak wavelength
-  if (maxVal <= 1) return "No Light";
+  if (maxVal <= Q16_ONE) return "No Light";
   else if (maxIndex <= 1) return "Violet";
   else if (maxIndex <= 3) return "Blue";
   else if (maxIndex <= 5) return "Green";
@@ -215,20 +506,20 @@ String detectColour18() {
   else if (maxIndex <= 14) return "Red";
   else return "NIR";
 }
-String detectColour10() {
+String detectColour10(const SpectralFrame &frame) {
   int maxIndex = 0;
-  float maxVal;
+  q16_t maxVal = 0;
   
   // Find the peak wavelength
   for (int i = 0; i < 9; i++) { //skips 10th channel as this is "clear"
-    if (readings10[i] > maxVal) {
-      maxVal = readings10[i];
+    if (frame.values[i] > maxVal) {
+      maxVal = frame.values[i];
       maxIndex = i+1;
     }
   }
   
   // Determine dominant colour based on peak wavelength
-  if (maxVal <= 1) return "No Light";
+  if (maxVal <= Q16_ONE) return "No Light";
   else if (maxIndex <= 1) return "Violet";
   else if (maxIndex <= 3) return "Blue";
   else if (maxIndex <= 5) return "Green";
@@ -238,300 +529,603 @@ String detectColour10() {
   else return "NIR";
 }
 
-uint8_t bananaRipeness(){ //compare prominence of ~650nm to ~550nm. Ratios close to 0.5 are unripe, 1 are ripe, 1.5 are overripe
-  float ripeness;
-  if(sensecon == 2){
-    ripeness = (static_cast<float>(intreadings[7]) / intreadings[4]) - 0.7; 
-    // ripeness = intreadings[6] / intreadings[4];
+uint8_t bananaRipeness(const SpectralFrame &frame){ //compare prominence of ~650nm to ~550nm. Ratios close to 0.5 are unripe, 1 are ripe, 1.5 are overripe
+  q16_t ripeness;
+  if(frame.channels == 10){
+    ripeness = q16SubSat(q16Ratio(frame.bars[7], frame.bars[4]), Q16_FROM_FLOAT(0.7f)); 
+    // ripeness = q16Ratio(frame.bars[6], frame.bars[4]);
   }
   else{
-    ripeness = (static_cast<float>(intreadings[8]) / intreadings[4]) - 0.7;
+    ripeness = q16SubSat(q16Ratio(frame.bars[8], frame.bars[4]), Q16_FROM_FLOAT(0.7f));
   }
-  if(ripeness<0){
-    ripeness = 0;
-  }
-  else if(ripeness>1){
-    ripeness = 1;
-  }
-  ripeness *= 158; //(scale so 0.5 ratio corresponds to 0 and 1.5 corresponds to 160 (full scale) with 1 in the middle)
-  return (uint8_t) ripeness;
+  ripeness = q16Clamp(ripeness, 0, Q16_ONE);
+  return q16Scale(ripeness, 158); //(scale so 0.5 ratio corresponds to 0 and 1.5 corresponds to 160 (full scale) with 1 in the middle)
 }
 
 /*
 Drawing Functions
 */
-void bigText(bool full, String text) {
-  display.setRotation(1); //sets landscape rotation
-  if(full){
-    display.setFullWindow(); //sets full refresh mode
-  }
-  else{
-    display.setPartialWindow(0, 0, display.width(), display.height()); //sets partial refresh mode 
+//left edge of each bar, AS7265x layout (the AS7341 bars are 3 + 25 * i, 19 wide)
+static const uint8_t barx18[18] = {3, 16, 30, 44, 58, 72, 85, 99, 113, 127, 140, 154, 168, 182, 195, 209, 223, 237};
+
+//error bars for a burst mean: black above each bar, white where they cross into it
+static void drawWhiskers(Adafruit_GFX &g, const SpectralFrame &frame){
+  if(frame.shots < 2) return;
+  for(uint8_t i = 0; i < frame.channels; i++){
+    if(frame.whiskers[i] == 0) continue;
+    int16_t x = (frame.channels == 18) ? barx18[i] + 4 : 12 + (i * 25);
+    int16_t top = 107 - frame.bars[i];
+    int16_t up = (top - frame.whiskers[i] < 38) ? 38 : top - frame.whiskers[i]; //stay inside the plot area
+    int16_t down = (top + frame.whiskers[i] > 107) ? 107 : top + frame.whiskers[i];
+    g.drawFastVLine(x, up, top - up, GxEPD_BLACK);
+    g.drawFastHLine(x - 2, up, 5, GxEPD_BLACK);
+    g.drawFastVLine(x, top, down - top, GxEPD_WHITE);
   }
-  display.firstPage();     //start paged drawing
+}
 
-  //Variables to store text bounds
-  int16_t x1, y1;
-  uint16_t w, h;
+//what drawMain()/drawMainRipe() last put on the panel, so the next call only refreshes what changed
+static struct {
+  bool valid; //false after bigText()/drawEmpty() or before the first result
+  bool ripe; //drawMainRipe() screen
+  uint8_t channels;
+  uint8_t bars[MAX_CHANNELS];
+  uint8_t whiskers[MAX_CHANNELS];
+  String toptext;
+  uint8_t ripeness;
+  uint8_t sensemode;
+  uint8_t ledmode;
+  bool contdraw;
+} drawn;
 
-  do {
-    //Set background for the current page
-    display.fillScreen(GxEPD_WHITE);
-    display.setFont(&FreeMonoBold9pt7b);
-    display.setTextColor(GxEPD_BLACK);
+//waterfall plot: landscape x from WATERFALL_X to the right edge, one column per frame
+static const int16_t WATERFALL_X = 22; //channel labels to the left
+static const int16_t WATERFALL_Y = 38; //below the title band
+static const int16_t WATERFALL_H = 84; //split evenly between the channels
+static const uint8_t WATERFALL_COLS = 250 - WATERFALL_X;
 
-    display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-    display.setCursor(((display.width() - w) / 2 - x1), ((display.height() - h) / 2 - y1));
-    display.print(text);
+//bar heights of the frames on the waterfall, in a ring of columns. The column after the newest is always
+//blank, so the ring holds at most WATERFALL_COLS - 1 frames and the gap shows where the newest one is
+static struct {
+  uint8_t bars[WATERFALL_COLS][MAX_CHANNELS];
+  uint8_t channels;
+  uint8_t next; //column the next frame goes in
+  uint8_t count; //frames in the ring
+  unsigned long timestamp; //newest frame, a redraw of the same frame adds nothing
+  bool shown; //the panel and the composition canvas hold the waterfall
+  uint8_t sensemode; //labels on the panel
+  uint8_t ledmode;
+  bool contdraw;
+} waterfallring;
 
-  } while (display.nextPage()); // Send page buffer & check if more pages
+/*
+Result Screen Composition
+*/
+//the result screens are composed in RAM in the panel's own layout (122x250, 16 bytes a row, 1 = white) and sent
+//as one image. GFXcanvas1 rotation 1 maps coordinates the same way as GxEPD2 rotation 1
+static const uint16_t PANEL_W = 122; //GxEPD2_DRIVER_CLASS::WIDTH_VISIBLE
+static const uint16_t PANEL_H = 250;
+static const size_t CANVAS_BYTES = ((PANEL_W + 7) / 8) * PANEL_H;
+static GFXcanvas1 background(PANEL_W, PANEL_H); //chart, mode labels and ripeness scale
+static GFXcanvas1 composed(PANEL_W, PANEL_H); //background plus bars, title and arrow
+
+//areas of the panel a partial refresh sends, in panel coordinates with x and w in whole bytes. They are kept
+//disjoint, and two are only merged when their bounding rectangle is no larger than the pair, so the title band
+//and runs of neighbouring bars go as separate windows rather than one rectangle around all of them
+struct PanelRect {
+  int16_t x, y, w, h;
+};
+static const uint8_t MAX_DIRTY = 8;
+static struct {
+  uint8_t count;
+  PanelRect rects[MAX_DIRTY];
+} dirty;
+
+static int32_t rectArea(const PanelRect &r){
+  return (int32_t)r.w * r.h;
 }
 
-void drawEmpty(bool full, String toptext) {
-  display.setRotation(1); //sets landscape rotation
-  if(full){
-    display.setFullWindow(); //sets full refresh mode
-  }
-  else{
-    display.setPartialWindow(0, 0, display.width(), display.height()); //sets partial refresh mode 
-  }
-  display.firstPage();     //start paged drawing
+static PanelRect boundRect(const PanelRect &a, const PanelRect &b){
+  PanelRect r;
+  r.x = min(a.x, b.x);
+  r.y = min(a.y, b.y);
+  r.w = max(a.x + a.w, b.x + b.w) - r.x;
+  r.h = max(a.y + a.h, b.y + b.h) - r.y;
+  return r;
+}
 
-  do {
-    //Set background for the current page
-    display.fillScreen(GxEPD_WHITE);
+static bool overlapRect(const PanelRect &a, const PanelRect &b){
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
 
-    //Draw empty bars (Bitmap)
-    display.drawBitmap(2, 37, base18, 245, 91, GxEPD_BLACK);
-    
-    //border to check boundaries
-    // display.drawRect(0, 6, 250, 122, GxEPD_BLACK);
-
-    //Draw measurement mode
-    display.setFont(); //default 5x7 font
-    display.setTextColor(GxEPD_BLACK);
-    if(sensemode == 0){
-      display.setCursor(181, 10);
-      display.print("Single Fire");
+//cuts b out of a where that leaves one rectangle (b spans a in one direction and covers one end of it),
+//a may end up empty. Returns false if a would have to be split
+static bool trimRect(PanelRect &a, const PanelRect &b){
+  if(b.y <= a.y && b.y + b.h >= a.y + a.h){ //b spans a's rows
+    if(b.x <= a.x){
+      int16_t x2 = a.x + a.w;
+      a.x = min(x2, (int16_t)(b.x + b.w));
+      a.w = x2 - a.x;
+      return true;
     }
-    else if(sensemode == 1){
-      display.setCursor(187, 10);
-      display.print("Continuous");
+    if(b.x + b.w >= a.x + a.w){
+      a.w = b.x - a.x;
+      return true;
     }
-    else{
-      display.setCursor(205, 10);
-      display.print("Burst ");
-      display.print(sensemode);
+  }
+  if(b.x <= a.x && b.x + b.w >= a.x + a.w){ //b spans a's byte columns
+    if(b.y <= a.y){
+      int16_t y2 = a.y + a.h;
+      a.y = min(y2, (int16_t)(b.y + b.h));
+      a.h = y2 - a.y;
+      return true;
     }
-    
-    //draw led mode
-    if(ledmode == 0){
-      display.setCursor(205, 23);
-      display.print("No LEDs");
+    if(b.y + b.h >= a.y + a.h){
+      a.h = b.y - a.y;
+      return true;
     }
-    else if(ledmode == 1){
-      display.setCursor(169, 23);
-      display.print("Internal LEDs");
+  }
+  return false;
+}
+
+static void removeDirty(uint8_t i){
+  dirty.rects[i] = dirty.rects[--dirty.count];
+}
+
+//adds a changed landscape rectangle to the dirty list, widened to whole bytes on the panel
+static void addDirty(int16_t x, int16_t y, int16_t w, int16_t h){
+  if(w <= 0 || h <= 0) return;
+  PanelRect n; //landscape (x, y) is panel (PANEL_W - 1 - y, x)
+  n.x = PANEL_W - y - h;
+  n.w = h;
+  n.y = x;
+  n.h = w;
+  n.w += n.x & 7; //byte-align on the panel
+  n.x &= ~7;
+  n.w = (n.w + 7) & ~7;
+
+  for(uint8_t i = 0; i < dirty.count;){
+    PanelRect &r = dirty.rects[i];
+    PanelRect b = boundRect(r, n);
+    if(rectArea(b) <= rectArea(r) + rectArea(n)){ //one window for no more bytes than two, start over with it
+      n = b;
+      removeDirty(i);
+      i = 0;
+      continue;
     }
-    else if(ledmode == 2){
-      display.setCursor(169, 23);
-      display.print("External LEDs");
+    if(!overlapRect(r, n)){i++; continue;}
+    if(trimRect(n, r)){
+      if(n.w <= 0 || n.h <= 0) return; //already covered
+      i++;
+      continue;
     }
-    else if(ledmode == 3){
-      display.setCursor(199, 23);
-      display.print("All LEDs");
+    if(trimRect(r, n)){
+      if(r.w <= 0 || r.h <= 0){removeDirty(i);}
+      else{i++;}
+      continue;
     }
-    else{
-      display.setCursor(175, 23);
-      display.print("Invalid Mode");
+    n = b; //neither can be cut out of the other
+    removeDirty(i);
+    i = 0;
+  }
+  if(dirty.count == MAX_DIRTY){ //full: the nearest one takes it in
+    uint8_t best = 0;
+    for(uint8_t i = 1; i < dirty.count; i++){
+      if(rectArea(boundRect(dirty.rects[i], n)) < rectArea(boundRect(dirty.rects[best], n))){best = i;}
     }
-
-    //Draw Title text (Set font, color, cursor, print)
-    display.setFont(&FreeMonoBold18pt7b);
-    display.setTextColor(GxEPD_BLACK);
-    display.setCursor(0, 27);
-    display.print(toptext);
-
-  } while (display.nextPage()); // Send page buffer & check if more pages
+    PanelRect b = boundRect(dirty.rects[best], n);
+    removeDirty(best);
+    addDirty(b.y, PANEL_W - b.x - b.w, b.h, b.w); //back to landscape, merged again with any it now overlaps
+    return;
+  }
+  dirty.rects[dirty.count++] = n;
 }
 
-void drawMain(bool full, String toptext, uint8_t *finalreadings) {
-  display.setRotation(1); //sets landscape rotation
-  if(full){
-    display.setFullWindow(); //sets full refresh mode
+//compares a result screen with the one on the panel and records it as drawn. Returns false if nothing changed,
+//otherwise the dirty list holds the changes: the band above the chart and each bar's slot (the bar and the gap
+//to the next one, so neighbouring changed bars join into one run)
+static bool changedRects(bool ripe, const String &toptext, uint8_t ripeness, const SpectralFrame &frame){
+  dirty.count = 0;
+  if(!drawn.valid || drawn.ripe != ripe || drawn.channels != frame.channels){ //different layout, everything
+    addDirty(0, 0, display.width(), display.height());
   }
   else{
-    display.setPartialWindow(0, 0, display.width(), display.height()); //sets partial refresh mode 
-  }
-  display.firstPage();     //start paged drawing
-
-  do {
-    //Set background for the current page
-    display.fillScreen(GxEPD_WHITE);
-    if(sensecon <= 1){ //for bogus data or AS7265x (18 channels)
-      display.drawBitmap(2, 37, base18, 245, 91, GxEPD_BLACK);
-      //Draw Filled bars (Rectangles)
-      display.fillRect(3, 107, 9, -finalreadings[0], GxEPD_BLACK);
-      display.fillRect(16, 107, 9, -finalreadings[1], GxEPD_BLACK);
-      display.fillRect(30, 107, 9, -finalreadings[2], GxEPD_BLACK);
-      display.fillRect(44, 107, 9, -finalreadings[3], GxEPD_BLACK);
-      display.fillRect(58, 107, 9, -finalreadings[4], GxEPD_BLACK);
-      display.fillRect(72, 107, 9, -finalreadings[5], GxEPD_BLACK);
-      display.fillRect(85, 107, 9, -finalreadings[6], GxEPD_BLACK);
-      display.fillRect(99, 107, 9, -finalreadings[7], GxEPD_BLACK);
-      display.fillRect(113, 107, 9, -finalreadings[8], GxEPD_BLACK);
-      display.fillRect(127, 107, 9, -finalreadings[9], GxEPD_BLACK);
-      display.fillRect(140, 107, 9, -finalreadings[10], GxEPD_BLACK);
-      display.fillRect(154, 107, 9, -finalreadings[11], GxEPD_BLACK);
-      display.fillRect(168, 107, 9, -finalreadings[12], GxEPD_BLACK);
-      display.fillRect(182, 107, 9, -finalreadings[13], GxEPD_BLACK);
-      display.fillRect(195, 107, 9, -finalreadings[14], GxEPD_BLACK);
-      display.fillRect(209, 107, 9, -finalreadings[15], GxEPD_BLACK);
-      display.fillRect(223, 107, 9, -finalreadings[16], GxEPD_BLACK);
-      display.fillRect(237, 107, 9, -finalreadings[17], GxEPD_BLACK);
+    //title, ripeness scale and mode labels share the band above the chart
+    if(drawn.toptext != toptext || drawn.ripeness != ripeness || drawn.sensemode != sensemode ||
+       drawn.ledmode != ledmode || drawn.contdraw != cont_flag_draw){
+      addDirty(0, 0, display.width(), 37);
     }
-    else{ //for AS7341 (10 channels)
-      display.drawBitmap(2, 37, base10, 246, 90, GxEPD_BLACK);
-      
-      for(uint8_t i = 0; i < 10; i++){
-        display.fillRect((3+(i*25)), 107, 19, -finalreadings[i], GxEPD_BLACK);
+    for(uint8_t i = 0; i < frame.channels; i++){
+      if(drawn.bars[i] == frame.bars[i] && drawn.whiskers[i] == frame.whiskers[i]) continue;
+      uint8_t reach = max(drawn.bars[i] + drawn.whiskers[i], frame.bars[i] + frame.whiskers[i]);
+      int16_t top = max(37, 105 - reach); //fillRect with a negative height reaches one row above the bar
+      if(frame.channels == 18){
+        int16_t right = (i < 17) ? barx18[i + 1] : display.width();
+        addDirty(barx18[i], top, right - barx18[i], 108 - top);
       }
+      else{addDirty(3 + (i * 25), top, 25, 108 - top);}
     }
+  }
 
-    //Draw measurement mode
-    display.setFont(); //default 5x7 font
-    display.setTextColor(GxEPD_BLACK);
-    if(sensemode == 0){
-      display.setCursor(181, 10);
-      display.print("Single Fire");
-    }
-    else if(sensemode == 1){
-      display.setCursor(187, 10);
-      if(cont_flag_draw){display.print("Cont. On");}
-      else{display.print("Cont. Off");}
-    }
-    else{
-      display.setCursor(205, 10);
-      display.print("Burst ");
-      display.print(sensemode);
-    }
-    
-    //draw led mode
-    if(ledmode == 0){
-      display.setCursor(205, 23);
-      display.print("No LEDs");
-    }
-    else if(ledmode == 1){
-      display.setCursor(169, 23);
-      display.print("Internal LEDs");
-    }
-    else if(ledmode == 2){
-      display.setCursor(169, 23);
-      display.print("External LEDs");
-    }
-    else if(ledmode == 3){
-      display.setCursor(199, 23);
-      display.print("All LEDs");
-    }
-    else{
-      display.setCursor(175, 23);
-      display.print("Invalid Mode");
+  drawn.valid = true;
+  drawn.ripe = ripe;
+  drawn.channels = frame.channels;
+  memcpy(drawn.bars, frame.bars, frame.channels);
+  memcpy(drawn.whiskers, frame.whiskers, frame.channels);
+  drawn.toptext = toptext;
+  drawn.ripeness = ripeness;
+  drawn.sensemode = sensemode;
+  drawn.ledmode = ledmode;
+  drawn.contdraw = cont_flag_draw;
+  return dirty.count > 0;
+}
+
+//what the background canvas currently holds, it is only redrawn when one of these changes
+static struct {
+  bool valid;
+  bool ripe;
+  uint8_t channels;
+  uint8_t sensemode;
+  uint8_t ledmode;
+  bool contdraw;
+} backgroundkey;
+
+//sense mode and LED mode labels, top right. The ripeness screen shows "Continuous" rather than the on/off state
+static void drawModeLabels(Adafruit_GFX &g, bool ripe){
+  g.setFont(); //default 5x7 font
+  g.setTextColor(GxEPD_BLACK);
+  if(sensemode == 0){
+    g.setCursor(181, 10);
+    g.print("Single Fire");
+  }
+  else if(sensemode == 1){
+    g.setCursor(187, 10);
+    if(ripe){g.print("Continuous");}
+    else if(cont_flag_draw){g.print("Cont. On");}
+    else{g.print("Cont. Off");}
+  }
+  else{
+    String burst = "Burst " + String(sensemode);
+    g.setCursor(247 - 6 * burst.length(), 10); //right aligned with the modes above, up to "Burst 255"
+    g.print(burst);
+  }
+
+  //draw led mode
+  if(ledmode == 0){
+    g.setCursor(205, 23);
+    g.print("No LEDs");
+  }
+  else if(ledmode == 1){
+    g.setCursor(169, 23);
+    g.print("Internal LEDs");
+  }
+  else if(ledmode == 2){
+    g.setCursor(169, 23);
+    g.print("External LEDs");
+  }
+  else if(ledmode == 3){
+    g.setCursor(199, 23);
+    g.print("All LEDs");
+  }
+  else{
+    g.setCursor(175, 23);
+    g.print("Invalid Mode");
+  }
+}
+
+//redraws the static part of a result screen if the layout or a mode has changed since the last one
+static void renderBackground(bool ripe, uint8_t channels){
+  bool contdraw = ripe ? false : cont_flag_draw; //not shown on the ripeness screen
+  if(backgroundkey.valid && backgroundkey.ripe == ripe && backgroundkey.channels == channels &&
+     backgroundkey.sensemode == sensemode && backgroundkey.ledmode == ledmode && backgroundkey.contdraw == contdraw) return;
+
+  background.setRotation(1); //landscape, as the display
+  background.fillScreen(GxEPD_WHITE);
+  if(channels == 18){drawPackedBitmap(background, 2, 37, base18_packed, GxEPD_BLACK);} //for bogus data or AS7265x (18 channels)
+  else{drawPackedBitmap(background, 2, 37, base10_packed, GxEPD_BLACK);} //for AS7341 (10 channels)
+  drawModeLabels(background, ripe);
+  if(ripe){drawPackedBitmap(background, 3, 8, ripescale_packed, GxEPD_BLACK);} //scale with labels
+
+  backgroundkey.valid = true;
+  backgroundkey.ripe = ripe;
+  backgroundkey.channels = channels;
+  backgroundkey.sensemode = sensemode;
+  backgroundkey.ledmode = ledmode;
+  backgroundkey.contdraw = contdraw;
+}
+
+//filled bars, rows 106-bar to 107 (the span the old fillRect(x, 107, w, -bar) calls covered)
+static void drawBars(Adafruit_GFX &g, const SpectralFrame &frame){
+  for(uint8_t i = 0; i < frame.channels; i++){
+    if(frame.channels == 18){g.fillRect(barx18[i], 106 - frame.bars[i], 9, frame.bars[i] + 2, GxEPD_BLACK);}
+    else{g.fillRect((3+(i*25)), 106 - frame.bars[i], 19, frame.bars[i] + 2, GxEPD_BLACK);}
+  }
+}
+
+//copies the background into the composition canvas, ready for the dynamic parts
+static void beginComposed(bool ripe, uint8_t channels){
+  renderBackground(ripe, channels);
+  memcpy(composed.getBuffer(), background.getBuffer(), CANVAS_BYTES);
+  composed.setRotation(1);
+}
+
+//sends the composed screen to the panel. Partial refreshes only send the dirty list's windows, to both controller
+//RAMs as GxEPD2's paged mode does, around one refresh: the update drives every pixel that differs between the RAMs,
+//so one refresh over their bounding rectangle covers them all
+static void pushComposed(bool full){
+  const uint8_t *buffer = composed.getBuffer();
+  renderpasses++;
+  if(full){ //as GxEPD2_BW::display(false): both RAMs, full refresh, previous RAM again, booster off
+    renderpixels += (uint32_t)PANEL_W * PANEL_H;
+    renderbytes += 3 * CANVAS_BYTES;
+    display.epd2.writeImageForFullRefresh(buffer, 0, 0, PANEL_W, PANEL_H);
+    display.epd2.refresh(false);
+    display.epd2.writeImageAgain(buffer, 0, 0, PANEL_W, PANEL_H);
+    display.epd2.powerOff();
+    return;
+  }
+  PanelRect all = dirty.rects[0];
+  for(uint8_t i = 0; i < dirty.count; i++){
+    const PanelRect &r = dirty.rects[i];
+    renderpixels += (uint32_t)min(r.w, (int16_t)(PANEL_W - r.x)) * r.h;
+    renderbytes += 2 * (uint32_t)(r.w / 8) * r.h;
+    display.epd2.writeImagePart(buffer, r.x, r.y, PANEL_W, PANEL_H, r.x, r.y, r.w, r.h);
+    all = boundRect(all, r);
+  }
+  display.epd2.refresh(all.x, all.y, all.w, all.h);
+  for(uint8_t i = 0; i < dirty.count; i++){
+    const PanelRect &r = dirty.rects[i];
+    display.epd2.writeImagePartAgain(buffer, r.x, r.y, PANEL_W, PANEL_H, r.x, r.y, r.w, r.h);
+  }
+}
+
+//start of a screen, for RENDER_STATS
+static void beginScreen(){
+  renderpasses = 0;
+  renderpixels = 0;
+  renderbytes = 0;
+  renderstart = micros();
+}
+
+//the display buffer holds the whole panel (one page), so the text screens are drawn into it once and sent with display()
+//instead of GxEPD2's firstPage()/nextPage() loop
+static_assert(MAX_HEIGHT(GxEPD2_DRIVER_CLASS) == GxEPD2_DRIVER_CLASS::HEIGHT, "display buffer must hold the whole panel");
+
+//sends the whole display buffer with display(), partial refresh unless full. A full refresh sends 3 buffers
+//(both RAMs, then the previous RAM again) and a partial one 2, as in pushComposed()
+static void pushDisplay(bool full){
+  display.display(!full);
+  renderpasses++;
+  renderpixels += (uint32_t)PANEL_W * PANEL_H;
+  renderbytes += (full ? 3 : 2) * CANVAS_BYTES;
+}
+
+//end of a screen, if RENDER_STATS is set reports its time on one line and what it sent on the next: the passes
+//(images sent and refreshed), the refreshed area, the SPI bytes and, for the composed screens (image set), a
+//checksum of the image. The second line is the
+//same on every run for the same screen, so a change in what a screen draws shows up without looking at the panel
+static void endScreen(const char *name, const uint8_t *image){
+  rendertime = micros() - renderstart;
+#if RENDER_STATS
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(rendertime);
+  Serial.println("us");
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(renderpasses);
+  Serial.print(" pass(es), ");
+  Serial.print(renderpixels);
+  Serial.print(" px, ");
+  Serial.print(renderbytes);
+  Serial.print(" bytes");
+  if(image){
+    uint32_t checksum = 2166136261UL; //FNV-1a over the panel-layout buffer
+    for(size_t i = 0; i < CANVAS_BYTES; i++){
+      checksum = (checksum ^ image[i]) * 16777619UL;
     }
+    Serial.print(", fnv ");
+    Serial.print(checksum, HEX);
+  }
+  Serial.println();
+#endif
+}
+
+void bigText(bool full, String text) {
+  mutex_enter_blocking(&displaymutex); //one core at a time on the SPI bus
+  drawn.valid = false; //the next result is drawn in full
+  waterfallring.shown = false;
+  beginScreen();
+  display.setRotation(1); //sets landscape rotation
+  display.setFullWindow(); //whole buffer, full or partial is picked by display()
+
+  //Variables to store text bounds
+  int16_t x1, y1;
+  uint16_t w, h;
 
-    //Draw Title text (Set font, color, cursor, print)
-    display.setFont(&FreeMonoBold18pt7b);
-    display.setTextColor(GxEPD_BLACK);
-    display.setCursor(0, 27);
-    display.print(toptext);
+  display.fillScreen(GxEPD_WHITE);
+  display.setFont(&FreeMonoBold9pt7b);
+  display.setTextColor(GxEPD_BLACK);
 
-  } while (display.nextPage()); // Send page buffer & check if more pages
+  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  display.setCursor(((display.width() - w) / 2 - x1), ((display.height() - h) / 2 - y1));
+  display.print(text);
+
+  pushDisplay(full); //send buffer, partial refresh unless full
+  endScreen("bigText", nullptr);
+  mutex_exit(&displaymutex);
 }
 
-void drawMainRipe(bool full, uint8_t ripeness, uint8_t *finalreadings) {
+void drawEmpty(bool full, String toptext) {
+  mutex_enter_blocking(&displaymutex); //one core at a time on the SPI bus
+  drawn.valid = false; //the next result is drawn in full
+  waterfallring.shown = false;
+  beginScreen();
   display.setRotation(1); //sets landscape rotation
-  if(full){
-    display.setFullWindow(); //sets full refresh mode
+  display.setFullWindow(); //whole buffer, full or partial is picked by display()
+
+  display.fillScreen(GxEPD_WHITE);
+
+  //Draw empty bars (Bitmap)
+  drawPackedBitmap(display, 2, 37, base18_packed, GxEPD_BLACK);
+  
+  //border to check boundaries
+  // display.drawRect(0, 6, 250, 122, GxEPD_BLACK);
+
+  //Draw measurement and led mode
+  drawModeLabels(display, true);
+
+  //Draw Title text (Set font, color, cursor, print)
+  display.setFont(&FreeMonoBold18pt7b);
+  display.setTextColor(GxEPD_BLACK);
+  display.setCursor(0, 27);
+  display.print(toptext);
+
+  pushDisplay(full); //send buffer, partial refresh unless full
+  endScreen("drawEmpty", nullptr);
+  mutex_exit(&displaymutex);
+}
+
+void drawMain(bool full, String toptext, const SpectralFrame &frame) {
+  mutex_enter_blocking(&displaymutex); //one core at a time on the SPI bus
+  display.setRotation(1); //sets landscape rotation
+  bool changed = changedRects(false, toptext, 0, frame);
+  if(!full && !changed){ //same as the panel already shows
+    mutex_exit(&displaymutex);
+    return;
   }
-  else{
-    display.setPartialWindow(0, 0, display.width(), display.height()); //sets partial refresh mode 
-  }
-  display.firstPage();     //start paged drawing
-
-  do {
-    //Set background for the current page
-    display.fillScreen(GxEPD_WHITE);
-    if(sensecon <= 1){ //for bogus data or AS7265x (18 channels)
-      display.drawBitmap(2, 37, base18, 245, 91, GxEPD_BLACK);
-      //Draw Filled bars (Rectangles)
-      display.fillRect(3, 107, 9, -finalreadings[0], GxEPD_BLACK);
-      display.fillRect(16, 107, 9, -finalreadings[1], GxEPD_BLACK);
-      display.fillRect(30, 107, 9, -finalreadings[2], GxEPD_BLACK);
-      display.fillRect(44, 107, 9, -finalreadings[3], GxEPD_BLACK);
-      display.fillRect(58, 107, 9, -finalreadings[4], GxEPD_BLACK);
-      display.fillRect(72, 107, 9, -finalreadings[5], GxEPD_BLACK);
-      display.fillRect(85, 107, 9, -finalreadings[6], GxEPD_BLACK);
-      display.fillRect(99, 107, 9, -finalreadings[7], GxEPD_BLACK);
-      display.fillRect(113, 107, 9, -finalreadings[8], GxEPD_BLACK);
-      display.fillRect(127, 107, 9, -finalreadings[9], GxEPD_BLACK);
-      display.fillRect(140, 107, 9, -finalreadings[10], GxEPD_BLACK);
-      display.fillRect(154, 107, 9, -finalreadings[11], GxEPD_BLACK);
-      display.fillRect(168, 107, 9, -finalreadings[12], GxEPD_BLACK);
-      display.fillRect(182, 107, 9, -finalreadings[13], GxEPD_BLACK);
-      display.fillRect(195, 107, 9, -finalreadings[14], GxEPD_BLACK);
-      display.fillRect(209, 107, 9, -finalreadings[15], GxEPD_BLACK);
-      display.fillRect(223, 107, 9, -finalreadings[16], GxEPD_BLACK);
-      display.fillRect(237, 107, 9, -finalreadings[17], GxEPD_BLACK);
-    }
-    else{ //for AS7341 (10 channels)
-      display.drawBitmap(2, 37, base10, 246, 90, GxEPD_BLACK);
-      
-      for(uint8_t i = 0; i < 10; i++){
-        display.fillRect((3+(i*25)), 107, 19, -finalreadings[i], GxEPD_BLACK);
-      }
-    }
 
-    //Draw measurement mode
-    display.setFont(); //default 5x7 font
-    display.setTextColor(GxEPD_BLACK);
-    if(sensemode == 0){
-      display.setCursor(181, 10);
-      display.print("Single Fire");
-    }
-    else if(sensemode == 1){
-      display.setCursor(187, 10);
-      display.print("Continuous");
-    }
-    else{
-      display.setCursor(205, 10);
-      display.print("Burst ");
-      display.print(sensemode);
-    }
-    
-    //draw led mode
-    if(ledmode == 0){
-      display.setCursor(205, 23);
-      display.print("No LEDs");
-    }
-    else if(ledmode == 1){
-      display.setCursor(169, 23);
-      display.print("Internal LEDs");
-    }
-    else if(ledmode == 2){
-      display.setCursor(169, 23);
-      display.print("External LEDs");
-    }
-    else if(ledmode == 3){
-      display.setCursor(199, 23);
-      display.print("All LEDs");
+  beginScreen();
+  waterfallring.shown = false; //the canvas is reused
+  beginComposed(false, frame.channels);
+  drawBars(composed, frame);
+  drawWhiskers(composed, frame);
+
+  //Draw Title text (Set font, color, cursor, print)
+  composed.setFont(&FreeMonoBold18pt7b);
+  composed.setTextColor(GxEPD_BLACK);
+  composed.setCursor(0, 27);
+  composed.print(toptext);
+
+  pushComposed(full);
+  endScreen("drawMain", composed.getBuffer());
+  mutex_exit(&displaymutex);
+}
+
+void drawMainRipe(bool full, uint8_t ripeness, const SpectralFrame &frame) {
+  mutex_enter_blocking(&displaymutex); //one core at a time on the SPI bus
+  display.setRotation(1); //sets landscape rotation
+  bool changed = changedRects(true, "", ripeness, frame);
+  if(!full && !changed){ //same as the panel already shows
+    mutex_exit(&displaymutex);
+    return;
+  }
+
+  beginScreen();
+  waterfallring.shown = false; //the canvas is reused
+  beginComposed(true, frame.channels);
+  drawBars(composed, frame);
+  drawWhiskers(composed, frame);
+  composed.drawBitmap(ripeness, 25, arrow, 7, 10, GxEPD_BLACK); //arrow
+
+  pushComposed(full);
+  endScreen("drawMainRipe", composed.getBuffer());
+  mutex_exit(&displaymutex);
+}
+
+/*
+Waterfall
+*/
+//4x4 ordered dither thresholds, a channel at level n (0-16) of 16 blacks n pixels in every 4x4 block
+static const uint8_t bayer4[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+//draws one ring column, channels top to bottom, darker for a higher bar
+static void drawWaterfallColumn(Adafruit_GFX &g, uint8_t col){
+  int16_t x = WATERFALL_X + col;
+  uint8_t rows = WATERFALL_H / waterfallring.channels;
+  for(uint8_t i = 0; i < waterfallring.channels; i++){
+    uint8_t level = (waterfallring.bars[col][i] * 16 + 34) / 69; //0-69 to 0-16, rounded
+    for(uint8_t r = 0; r < rows; r++){
+      int16_t y = WATERFALL_Y + i * rows + r;
+      g.drawPixel(x, y, (level > bayer4[y & 3][x & 3]) ? GxEPD_BLACK : GxEPD_WHITE);
     }
-    else{
-      display.setCursor(175, 23);
-      display.print("Invalid Mode");
+  }
+}
+
+//title and mode labels, the band above the plot
+static void drawWaterfallTitle(Adafruit_GFX &g){
+  g.setFont(&FreeMonoBold9pt7b);
+  g.setTextColor(GxEPD_BLACK);
+  g.setCursor(0, 22);
+  g.print("Waterfall");
+  drawModeLabels(g, false);
+  waterfallring.sensemode = sensemode;
+  waterfallring.ledmode = ledmode;
+  waterfallring.contdraw = cont_flag_draw;
+}
+
+//redraws the whole waterfall screen from the ring into the composition canvas
+static void renderWaterfall(){
+  composed.setRotation(1);
+  composed.fillScreen(GxEPD_WHITE);
+  drawWaterfallTitle(composed);
+
+  //first and last channel next to their rows, wavelength only
+  const char *first = (waterfallring.channels == 10) ? wavelengthNames10[0] : wavelengthNames18[0];
+  const char *last = (waterfallring.channels == 10) ? wavelengthNames10[9] : wavelengthNames18[17];
+  int16_t plotheight = (WATERFALL_H / waterfallring.channels) * waterfallring.channels;
+  composed.setFont();
+  composed.setCursor(0, WATERFALL_Y);
+  composed.write((const uint8_t*)first, 3);
+  composed.setCursor(0, WATERFALL_Y + plotheight - 7);
+  composed.write((const uint8_t*)last, 3);
+  composed.drawFastVLine(WATERFALL_X - 2, WATERFALL_Y, plotheight, GxEPD_BLACK);
+
+  for(uint8_t n = 0; n < waterfallring.count; n++){
+    drawWaterfallColumn(composed, (waterfallring.next + WATERFALL_COLS - waterfallring.count + n) % WATERFALL_COLS);
+  }
+}
+
+void drawWaterfall(bool full, const SpectralFrame &frame){
+  mutex_enter_blocking(&displaymutex); //one core at a time on the SPI bus
+  display.setRotation(1); //sets landscape rotation
+  drawn.valid = false; //the bar screens are drawn in full after this
+  if(waterfallring.channels != frame.channels){ //other sensor, the old history does not fit
+    waterfallring.channels = frame.channels;
+    waterfallring.next = 0;
+    waterfallring.count = 0;
+    waterfallring.shown = false;
+  }
+
+  beginScreen();
+  dirty.count = 0;
+  if(frame.timestamp != 0 && frame.timestamp != waterfallring.timestamp){ //a new frame, into the ring
+    uint8_t col = waterfallring.next;
+    memcpy(waterfallring.bars[col], frame.bars, frame.channels);
+    waterfallring.timestamp = frame.timestamp;
+    waterfallring.next = (col + 1) % WATERFALL_COLS;
+    if(waterfallring.count < WATERFALL_COLS - 1){waterfallring.count++;}
+    if(waterfallring.shown){ //the new column, and the oldest one cleared to keep the gap
+      drawWaterfallColumn(composed, col);
+      composed.drawFastVLine(WATERFALL_X + waterfallring.next, WATERFALL_Y, WATERFALL_H, GxEPD_WHITE);
+      addDirty(WATERFALL_X + col, WATERFALL_Y, 1, WATERFALL_H);
+      addDirty(WATERFALL_X + waterfallring.next, WATERFALL_Y, 1, WATERFALL_H); //a second window at the wrap
     }
+  }
 
-    //Draw Ripeness Scale
-    display.drawBitmap(3, 8, ripescale, 170, 16, GxEPD_BLACK); //scale with labels
-    display.drawBitmap(ripeness, 25, arrow, 7, 10, GxEPD_BLACK); //arrow
+  if(!waterfallring.shown){
+    renderWaterfall();
+    waterfallring.shown = true;
+    dirty.count = 0;
+    addDirty(0, 0, display.width(), display.height());
+  }
+  else if(waterfallring.sensemode != sensemode || waterfallring.ledmode != ledmode || waterfallring.contdraw != cont_flag_draw){
+    composed.fillRect(0, 0, display.width(), WATERFALL_Y - 1, GxEPD_WHITE);
+    drawWaterfallTitle(composed);
+    addDirty(0, 0, display.width(), WATERFALL_Y - 1);
+  }
 
-  } while (display.nextPage()); // Send page buffer & check if more pages
+  if(full){pushComposed(true);}
+  else if(dirty.count > 0){pushComposed(false);}
+  endScreen("drawWaterfall", composed.getBuffer());
+  mutex_exit(&displaymutex);
 }
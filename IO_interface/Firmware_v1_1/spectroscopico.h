@@ -17,14 +17,20 @@ Includes
 #include <GxEPD2_BW.h> //E-Paper display library
 #include <RotaryEncoder.h> //Rotary encoder library
 #include <SparkFun_AS7265X.h> //AS7265x spectral sensor library (18 channels)
-#include <Adafruit_AS7341.h> //AS7341 spectral sensor library (10 channels + flicker detect)
 
 #include "Fonts/FreeMonoBold9pt7b.h" //Medium font
 #include "Fonts/FreeMonoBold18pt7b.h" //Large font
 
-#include "18chanbase.h" //Custom bitmap for base UI (AS7265x)
-#include "10chanbase.h" //Custom bitmap for base UI (AS7341)
-#include "ripescale.h" //Bitmaps for ripeness scale and arrow
+#include "packed_bitmaps.h" //Base UI (AS7265x, AS7341) and ripeness scale bitmaps, packed from 18chanbase.h, 10chanbase.h, ripescale.h
+#include "ripescale.h" //Arrow bitmap (10 bytes, drawn every frame, left unpacked)
+#include "as7265x_bulk.h" //Bulk calibrated readout for AS7265x
+#include "as7341_driver.h" //Register-level AS7341 driver (10 channels)
+#include "as7341_autoexposure.h" //Gain and integration time control for the AS7341
+#include "spectral_frame.h" //Frame type passed between acquisition, processing and drawing
+#include "dark_cache.h" //Dark frames per exposure setting
+#include "frame_queue.h" //Lock-free core0 -> core1 frame ring
+#include "fixedpoint.h" //Q16.16 helpers for the processing path
+#include "welford.h" //Streaming Q16.16 mean/standard deviation for bursts
 
 /*
 Global Objects and Variables, defined in .ino
@@ -32,27 +38,60 @@ Global Objects and Variables, defined in .ino
 extern GxEPD2_DISPLAY_CLASS<GxEPD2_DRIVER_CLASS, MAX_HEIGHT(GxEPD2_DRIVER_CLASS)> display;
 extern SPIClassRP2040 SPIn;
 extern RotaryEncoder *encoder;
-extern Adafruit_AS7341 as7341;
+extern AS7341Driver as7341;
+extern AS7341AutoExposure as7341ae;
 extern AS7265X sensor;
 /*
 Global Objects and Variables, defined in .cpp
 */
 extern int8_t pos;
 extern int8_t newpos;
-extern float readings18[18];
-extern uint16_t readings10[10]; //F1,2,3,4,5,CLR,NIR,F6,F7,F8
-extern uint8_t intreadings[18];
-extern uint8_t intreadingsmem[9][18];
 extern volatile bool cont_flag_draw;
+extern volatile bool waterfall; //continuous mode shows the waterfall instead of the bar chart
+extern volatile bool booted; //set at the end of setup(), core1 waits for it before touching the display
+extern volatile bool redrawrequest; //set by the IO handlers, core1 redraws the frame on screen
+extern volatile bool measuringrequest; //set by the IO handlers, core1 shows "Measuring..." until the result is in
+extern uint8_t renderpasses; //images the last screen sent to the panel and refreshed, counted where they are sent
+extern unsigned long rendertime; //us the last screen took to draw and send
+extern uint32_t renderpixels; //pixels in the area the last screen refreshed
+extern uint32_t renderbytes; //image bytes the last screen sent over SPI, both controller RAMs
 extern uint8_t sensecon; //sensor connected (0 = none, 1 = AS7265x, 2 = AS7341)
 extern uint8_t ledmode; //led mode (0 = none, 1 = internal, 2 = external, 3 = both)
-extern uint8_t sensemode; //sense mode (0 = single fire, 1 = continuous, 2 = burst of 2, 3 = burst of 3, etc.)
+extern uint8_t sensemode; //sense mode, one of sensemodes[] in IO_handler.h: 0 = single fire, 1 = continuous (bars, or the waterfall when waterfall is set), 4/16/64/200 = burst of that many
+extern volatile uint8_t burstleft; //shots still to take in the running burst, 0 when no burst is running
 extern volatile bool ledState; //holds state of builtin LED (debug use)
 extern volatile bool measuring; //true when a measurement should be taken
 extern volatile bool buttonpress;
 extern volatile unsigned long lastInterruptTime; //previous button interrupt time
 extern const unsigned long debounceDelay; //button interrupt delay
 
+/*
+Acquisition State
+*/
+enum AcqState : uint8_t {
+  ACQ_IDLE,        //no integration running
+  ACQ_INTEGRATING, //integration started, waiting for the sensor's data-ready flag
+  ACQ_READY        //data ready, waiting for collectMeasure()
+};
+static const unsigned long ACQ_POLL_INTERVAL = 5; //ms between data-ready checks on the I2C bus
+static const unsigned long ACQ_TIMEOUT = 3000; //ms before an integration is collected regardless
+static const uint8_t AS7265X_GAIN_CODE = 3; //64x, set by AS7265X::begin()
+static const uint32_t AS7265X_INTEGRATION = 49UL * 2800; //us, 49 cycles set by AS7265X::begin()
+extern volatile uint8_t acqstate; //one of AcqState
+
+/*
+Rendering
+*/
+//a frame waiting to be drawn by core1, and which screen it goes on
+struct RenderJob {
+  SpectralFrame frame;
+  bool enc; //true for drawMain, false for drawMainRipe
+};
+static const uint8_t RENDER_QUEUE_SIZE = 16; //power of two, one slot holds the frame on screen. Covers a 4s full refresh at the fastest integration
+extern uint16_t refreshinterval; //ms, shortest time between two panel refreshes (0 = as fast as the panel goes)
+extern uint8_t fullrefreshevery; //every Nth refresh is a full one to clear ghosting (0 = never)
+extern uint32_t framesdrawn; //frames core1 has drawn
+
 /*
 Lookup Tables
 */
@@ -65,24 +104,56 @@ extern const char* wavelengthNames10[]; //holds wavelength names and values for
 // Spectral Reading Functions
 //----------------------------------------------------------------------------------------------------//
 //spectral reading, ledmode 0 for no LEDs, 1 for inbuilt LEDs, (2 for external LEDs, 4 for all LEDs)
-void measure();
+void measure(SpectralFrame &frame);
+
+//non-blocking version of measure(): start an integration, poll until it is ready, then collect the readings
+//collectMeasure() returns false when the integration was a dark frame for the cache (nothing to show)
+void startMeasure();
+bool pollMeasure();
+bool collectMeasure(SpectralFrame &frame);
+void abortMeasure();
+
+//scale frame.values into frame.bars (0-69) for display
+void normalise(SpectralFrame &frame);
+#define FIXEDPOINT_CYCLES 0 //1 prints the cycles of every continuous frame's conversion and normalise() against the float code over Serial
+
+//core1 loop: draws the newest frame and handles redraw requests, at most once per refreshinterval
+void renderStep();
+uint32_t framesdropped(); //frames never drawn: skipped for a newer one, or lost to a full ring
+
+//continuous mode step, call repeatedly from loop(). Draws each frame while the next one integrates
+void contmeasure(bool enc);
 
 //should first draw "waiting for reading", then take a reading if sensor connected or generate fake results, then finally draw the data on the screen
 void multimeasure(bool enc);
 
+//burst mode (sensemode > 1): startBurst() arms it, burstmeasure() is called from loop() until burstleft is 0
+//and draws the mean with standard deviation whiskers, stopBurst() abandons it
+void startBurst(uint8_t shots);
+void burstmeasure(bool enc);
+void stopBurst();
+
 //determine the dominant colour (based on Sparkfun example)
-String detectColour18();
-String detectColour10();
+String detectColour(const SpectralFrame &frame);
+String detectColour18(const SpectralFrame &frame);
+String detectColour10(const SpectralFrame &frame);
 
 //determine ripeness of a banana
-uint8_t bananaRipeness();
+uint8_t bananaRipeness(const SpectralFrame &frame);
 
 //----------------------------------------------------------------------------------------------------//
 // Screen Print Functions
 //----------------------------------------------------------------------------------------------------//
+#define RENDER_STATS 0 //1 prints the time, passes, refreshed area, SPI bytes and image checksum of every screen over Serial
+
 void bigText(bool full, String text);
 void drawEmpty(bool full, String toptext);
-void drawMain(bool full, String toptext, uint8_t *finalreadings);
-void drawMainRipe(bool full, uint8_t ripeness, uint8_t *finalreadings);
+void drawMain(bool full, String toptext, const SpectralFrame &frame);
+void drawMainRipe(bool full, uint8_t ripeness, const SpectralFrame &frame);
+void drawResult(bool full, bool enc, const SpectralFrame &frame); //drawMain or drawMainRipe, as picked by the encoder button, or drawWaterfall
+
+//continuous mode time series: one column of dithered channel intensities per frame, oldest overwritten first.
+//A new frame only refreshes its own column and the blank one after it (one or two panel rows)
+void drawWaterfall(bool full, const SpectralFrame &frame);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef _WELFORD_H
+#define _WELFORD_H
+
+#include <Arduino.h>
+#include "fixedpoint.h"
+
+/*
+Streaming mean and variance per channel (Welford's algorithm), on Q16.16 readings. Each shot is folded
+in as it arrives, so a burst needs 12 bytes per channel and no history. The mean moves by |delta| / count,
+rounded, a 32 bit divide; the sum of squared differences is kept in 64 bits at 2^-24 resolution, which holds
+255 shots (the longest burst) of readings up to 65535. The only 64 bit divide is one per channel when
+stddev() is read at the end of the burst.
+*/
+template <uint8_t N>
+class Welford {
+public:
+  void reset(){
+    _count = 0;
+    for(uint8_t i = 0; i < N; i++){
+      _mean[i] = 0;
+      _m2[i] = 0;
+    }
+  }
+
+  //folds one shot of channels values (channels <= N) into the running statistics
+  void add(const q16_t *values, uint8_t channels){
+    _count++;
+    for(uint8_t i = 0; i < channels; i++){
+      q16_t x = values[i];
+      bool above = x >= _mean[i];
+      uint32_t delta = above ? x - _mean[i] : _mean[i] - x;
+      uint32_t step = delta / _count; //rounded, so the mean doesn't drift towards its first value
+      if(2 * (delta % _count) >= _count){step++;}
+      _mean[i] = above ? _mean[i] + step : _mean[i] - step;
+      uint32_t delta2 = above ? x - _mean[i] : _mean[i] - x; //same sign as delta
+      _m2[i] += ((uint64_t)delta * delta2 + 128) >> 8; //rounded
+    }
+  }
+
+  uint16_t count(){return _count;}
+  q16_t mean(uint8_t i){return _mean[i];}
+  //sample standard deviation, 0 until there are two shots
+  q16_t stddev(uint8_t i){
+    if(_count < 2) return 0;
+    uint64_t variance = _m2[i] / (_count - 1); //2^-24 resolution, 2^-32 wanted before the square root
+    return (variance >> 56) ? isqrt(variance) << 4 : isqrt(variance << 8);
+  }
+
+private:
+  //floor(sqrt(n)), bit by bit
+  static uint32_t isqrt(uint64_t n){
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    while(bit > n){bit >>= 2;}
+    while(bit){
+      if(n >= root + bit){
+        n -= root + bit;
+        root = (root >> 1) + bit;
+      }
+      else{root >>= 1;}
+      bit >>= 2;
+    }
+    return root;
+  }
+
+  uint16_t _count = 0;
+  q16_t _mean[N] = {};
+  uint64_t _m2[N] = {}; //sum of squared differences from the mean, 2^-24 units
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+The Q16.16 processing path against the float code it replaced, on the host: the calibrated float readings
+converted with q16FromFloat plus normalise(), bananaRipeness(), and a 16 shot burst folded into Welford.
+The host has an FPU, so these only show the fixed point path isn't out of line; they don't carry over to
+the RP2040, which has none. The device numbers come from FIXEDPOINT_CYCLES (spectroscopico.h), and no
+claim about the device is made without them.
+*/
+#include <spectroscopico.h>
+#include <chrono>
+
+static const uint32_t FRAMES = 200000;
+static SpectralFrame frames[64];
+static float readings[64][MAX_CHANNELS]; //as read from the AS7265x
+static volatile uint32_t sink;
+
+static void floatNormalise(SpectralFrame &frame, const float *values){
+  float maxReading = 0;
+  for(int i = 0; i < frame.channels; i++){
+    if(values[i] > maxReading) maxReading = values[i];
+  }
+  for(int i = 0; i < frame.channels; i++){
+    frame.bars[i] = (maxReading == 0) ? 0 : values[i] / maxReading * 69;
+  }
+}
+
+static void fixedNormalise(SpectralFrame &frame, const float *values){
+  for(int i = 0; i < frame.channels; i++){
+    frame.values[i] = q16FromFloat(values[i]);
+  }
+  normalise(frame);
+}
+
+//the float Welford burst statistics before Q16.16
+class FloatWelford {
+public:
+  void reset(){
+    _count = 0;
+    for(uint8_t i = 0; i < MAX_CHANNELS; i++){_mean[i] = 0; _m2[i] = 0;}
+  }
+  void add(const float *values, uint8_t channels){
+    _count++;
+    for(uint8_t i = 0; i < channels; i++){
+      float delta = values[i] - _mean[i];
+      _mean[i] += delta / _count;
+      _m2[i] += delta * (values[i] - _mean[i]);
+    }
+  }
+  float stddev(uint8_t i){return (_count > 1) ? sqrtf(_m2[i] / (_count - 1)) : 0;}
+private:
+  uint16_t _count = 0;
+  float _mean[MAX_CHANNELS] = {};
+  float _m2[MAX_CHANNELS] = {};
+};
+
+static uint8_t floatRipeness(const SpectralFrame &frame){
+  float ripeness = (static_cast<float>(frame.bars[8]) / frame.bars[4]) - 0.7;
+  if(ripeness < 0){ripeness = 0;}
+  else if(ripeness > 1){ripeness = 1;}
+  return (uint8_t)(ripeness * 158);
+}
+
+//f(n) for frame n of the 64, FRAMES times
+template <typename F>
+static double nsPerFrame(F f){
+  auto start = std::chrono::steady_clock::now();
+  for(uint32_t n = 0; n < FRAMES; n++){f(n & 63);}
+  std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+  return took.count() / FRAMES;
+}
+
+int main(){
+  for(uint8_t f = 0; f < 64; f++){
+    frames[f].channels = 18;
+    frames[f].shots = 1;
+    for(uint8_t i = 0; i < 18; i++){readings[f][i] = (1 + (f * 37 + i * 101) % 4000) * 0.37f;}
+  }
+  printf("per 18 channel frame, host\n");
+  printf("  normalise, float:       %.1f ns\n", nsPerFrame([](uint8_t f){floatNormalise(frames[f], readings[f]); sink += frames[f].bars[0];}));
+  printf("  normalise, Q16.16:      %.1f ns (with the conversion from float)\n",
+         nsPerFrame([](uint8_t f){fixedNormalise(frames[f], readings[f]); sink += frames[f].bars[0];}));
+  for(uint8_t f = 0; f < 64; f++){frames[f].bars[4] = 1 + f;}
+  printf("  bananaRipeness, float:  %.1f ns\n", nsPerFrame([](uint8_t f){sink += floatRipeness(frames[f]);}));
+  printf("  bananaRipeness, Q16.16: %.1f ns\n", nsPerFrame([](uint8_t f){sink += bananaRipeness(frames[f]);}));
+
+  static FloatWelford floatstats;
+  static Welford<MAX_CHANNELS> stats;
+  printf("per 16 shot burst, host\n");
+  printf("  Welford, float:         %.1f ns\n", nsPerFrame([](uint8_t f){
+    floatstats.reset();
+    for(uint8_t s = 0; s < 16; s++){floatstats.add(readings[(f + s) & 63], 18);}
+    sink += floatstats.stddev(0);
+  }));
+  printf("  Welford, Q16.16:        %.1f ns\n", nsPerFrame([](uint8_t f){
+    stats.reset();
+    for(uint8_t s = 0; s < 16; s++){stats.add(frames[(f + s) & 63].values, 18);}
+    sink += stats.stddev(0);
+  }));
+  return 0;
+}
@@ -0,0 +1,65 @@
+/*
+Core0 -> core1 handover throughput on the host: FrameQueue against the same ring guarded by a mutex, two
+threads passing SpectralFrame-sized jobs. Host numbers, for comparing the two, not RP2040 timings.
+*/
+#include <frame_queue.h>
+#include <spectral_frame.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <stdio.h>
+
+struct Job {
+  SpectralFrame frame;
+  bool enc;
+};
+
+static const uint32_t JOBS = 2000000;
+
+//the ring with a lock around every index access, as a locked handover would be
+template <typename T, uint8_t N>
+class LockedQueue {
+public:
+  T* claim(){std::lock_guard<std::mutex> l(_m); return (uint8_t)(_head - _tail) == N ? nullptr : &_slots[_head & (N - 1)];}
+  void publish(){std::lock_guard<std::mutex> l(_m); _head++;}
+  T* front(){std::lock_guard<std::mutex> l(_m); return _tail == _head ? nullptr : &_slots[_tail & (N - 1)];}
+  void pop(){std::lock_guard<std::mutex> l(_m); _tail++;}
+
+private:
+  T _slots[N];
+  uint8_t _head = 0, _tail = 0;
+  std::mutex _m;
+};
+
+template <typename Q>
+static double run(Q &queue){
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&]{
+    for(uint32_t i = 0; i < JOBS; i++){
+      Job *job;
+      while(!(job = queue.claim())){std::this_thread::yield();}
+      job->frame.timestamp = i;
+      job->frame.values[0] = i;
+      queue.publish();
+    }
+  });
+  uint32_t n = 0;
+  while(n < JOBS){
+    Job *job = queue.front();
+    if(!job){std::this_thread::yield(); continue;}
+    n += (job->frame.timestamp == n);
+    queue.pop();
+  }
+  producer.join();
+  std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+  return JOBS / took.count() / 1e6;
+}
+
+int main(){
+  static FrameQueue<Job, 16> lockfree;
+  static LockedQueue<Job, 16> locked;
+  printf("handover, %u jobs of %u bytes, 16 slots\n", JOBS, (unsigned)sizeof(Job));
+  printf("  FrameQueue:    %.2f Mjobs/s\n", run(lockfree));
+  printf("  mutex guarded: %.2f Mjobs/s\n", run(locked));
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include "as7265x_mock.h"
+#include "spectra.h"
+#include "host.h"
+
+//wavelength of each calibrated float, devices NIR, visible, UV
+const float AS7265xMock::wavelengths[3][6] = {
+  {610, 680, 730, 760, 810, 860}, //R S T U V W
+  {560, 585, 645, 705, 900, 940}, //G H I J K L
+  {410, 435, 460, 485, 510, 535}  //A B C D E F
+};
+
+void AS7265xMock::receive(const uint8_t *data, size_t len){
+  if(len == 0) return;
+  _pointer = data[0];
+  if(len < 2 || _pointer != 0x01) return; //only WRITE takes data
+  uint8_t b = data[1];
+  if(stuck) return;
+  uint64_t now = hostMicros();
+  _txbusy = now + txlatency;
+  if(_pendingwrite >= 0){
+    virtualWrite(_pendingwrite, b);
+    _pendingwrite = -1;
+  }
+  else if(b & 0x80){
+    _pendingwrite = b & 0x7F;
+  }
+  else{
+    _rxdata = virtualRead(b);
+    _rxvalid = true;
+    _rxready = now + rxlatency;
+  }
+}
+
+void AS7265xMock::request(uint8_t *data, size_t len){
+  uint64_t now = hostMicros();
+  for(size_t i = 0; i < len; i++){
+    if(_pointer == 0x00){ //STATUS
+      data[i] = ((stuck || now < _txbusy) ? 0x02 : 0) | ((_rxvalid && now >= _rxready) ? 0x01 : 0);
+    }
+    else if(_pointer == 0x02){ //READ
+      data[i] = _rxdata;
+      _rxvalid = false;
+    }
+    else{
+      data[i] = 0;
+    }
+  }
+}
+
+uint8_t AS7265xMock::virtualRead(uint8_t addr){
+  virtualreads++;
+  if(addr == 0x04) return _config;
+  if(addr == 0x05) return _integration;
+  if(addr == 0x07) return _ledconfig[_selected];
+  if(addr == 0x4F) return 0x30 | _selected; //both slaves present
+  if(addr >= 0x14 && addr < 0x2C){ //calibrated floats, MSB first
+    uint8_t c = (addr - 0x14) / 4;
+    uint32_t bits;
+    memcpy(&bits, &calibrated[_selected][c], 4);
+    return bits >> (8 * (3 - (addr - 0x14) % 4));
+  }
+  return 0;
+}
+
+void AS7265xMock::virtualWrite(uint8_t addr, uint8_t value){
+  virtualwrites++;
+  if(addr == 0x04){
+    _config = value & ~0x02; //DATA_RDY is read only, a write restarts the measurement
+    if(((value >> 2) & 3) == 3){startOneShot();}
+  }
+  else if(addr == 0x05){_integration = value;}
+  else if(addr == 0x07){_ledconfig[_selected] = value;}
+  else if(addr == 0x4F){
+    _selected = (value < 3) ? value : 0;
+    selects++;
+  }
+}
+
+void AS7265xMock::startOneShot(){
+  _config &= ~0x02;
+  if(_event){hostCancel(_event);}
+  _event = 0;
+  if(nodata) return;
+  uint64_t period = (uint64_t)(_integration + 1) * 2800;
+  _event = hostAt(hostMicros() + 2 * period, [this]{complete();});
+}
+
+//the scaled scene at the end of the integration, 64x gain and 50 cycles give ~1000 at the peak
+void AS7265xMock::complete(){
+  _event = 0;
+  bool lit = hostPin(16);
+  for(uint8_t d = 0; d < 3; d++){
+    if(_ledconfig[d] & 0x08){lit = true;}
+  }
+  static const float gains[4] = {1, 3.7f, 16, 64};
+  float scale = 1000.0f * gains[(_config >> 4) & 3] / 64 * (_integration + 1) / 50;
+  for(uint8_t d = 0; d < 3; d++){
+    for(uint8_t c = 0; c < 6; c++){
+      calibrated[d][c] = scale * hostIrradiance(wavelengths[d][c], hostMicros(), lit);
+    }
+  }
+  lastlit = lit;
+  measurements++;
+  _config |= 0x02; //DATA_RDY
+}
@@ -0,0 +1,54 @@
+#ifndef _HOST_AS7265X_MOCK_H
+#define _HOST_AS7265X_MOCK_H
+
+#include <Wire.h>
+
+/*
+AS7265x triad on the I2C bus model: the physical STATUS/WRITE/READ registers and the virtual register
+protocol behind them. A byte written to WRITE keeps TX_VALID set for txlatency us while the master consumes
+it, and a read address puts its data in READ (RX_VALID) rxlatency us later. The latencies are assumptions
+of the model, not datasheet figures. A one-shot measurement (CONFIG bank mode 3) sets DATA_RDY after two
+integration periods and latches calibrated values from the scene (spectra.h) for all three devices; the
+LEDs count as on when any bulb bit is set or the external LED pin is high.
+*/
+class AS7265xMock : public HostI2CDevice {
+public:
+  uint8_t address() const override {return 0x49;}
+  void receive(const uint8_t *data, size_t len) override;
+  void request(uint8_t *data, size_t len) override;
+
+  //starts a one-shot measurement as if CONFIG had been written (for tests that skip the library)
+  void startOneShot();
+
+  uint32_t txlatency = 300; //us
+  uint32_t rxlatency = 600; //us
+  bool stuck = false; //TX_VALID never clears (a hung master), for timeout tests
+  bool nodata = false; //measurements never finish (DATA_RDY stays clear), for the acquisition timeout
+  uint32_t virtualreads = 0;
+  uint32_t virtualwrites = 0;
+  uint32_t selects = 0; //DEV_SELECT_CONTROL writes
+  uint32_t measurements = 0; //one-shot measurements completed
+  bool lastlit = false; //LEDs of the last measurement
+
+  float calibrated[3][6] = {}; //per device, R_G_A..W_L_F order
+  static const float wavelengths[3][6];
+
+private:
+  uint8_t virtualRead(uint8_t addr);
+  void virtualWrite(uint8_t addr, uint8_t value);
+  void complete();
+
+  uint8_t _pointer = 0;
+  int16_t _pendingwrite = -1; //virtual address waiting for its data byte
+  uint64_t _txbusy = 0; //TX_VALID until then
+  bool _rxvalid = false;
+  uint64_t _rxready = 0;
+  uint8_t _rxdata = 0;
+  uint8_t _selected = 0;
+  uint8_t _config = 0;
+  uint8_t _integration = 0xFF;
+  uint8_t _ledconfig[3] = {};
+  uint32_t _event = 0;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "as7341_mock.h"
+#include "spectra.h"
+#include "host.h"
+
+static const uint8_t ENABLE = 0x80, ATIME = 0x81, ID = 0x92, STATUS = 0x93, ASTATUS = 0x94;
+static const uint8_t CFG1 = 0xAA, CFG6 = 0xAF, CFG9 = 0xB2, ASTEP_L = 0xCA, ASTEP_H = 0xCB, INTENAB = 0xF9;
+static const uint8_t PON = 0x01, SP_EN = 0x02, SMUXEN = 0x10, SINT = 0x01, AINT = 0x08;
+
+const float AS7341Mock::wavelengths[2][6] = {
+  {415, 445, 480, 515, 0, 910}, //F1 F2 F3 F4 CLEAR NIR
+  {555, 590, 630, 680, 0, 910}  //F5 F6 F7 F8 CLEAR NIR
+};
+
+AS7341Mock::AS7341Mock(uint8_t intPin) : _intPin(intPin) {
+  _regs[ID] = 0x09 << 2;
+  _regs[ASTEP_L] = 0xE7; //999, the power-on default
+  _regs[ASTEP_H] = 0x03;
+  _regs[CFG1] = 0x09;
+}
+
+uint64_t AS7341Mock::integrationTime() const {
+  uint32_t astep = _regs[ASTEP_L] | (_regs[ASTEP_H] << 8);
+  return (uint64_t)(_regs[ATIME] + 1) * (astep + 1) * 278 / 100;
+}
+
+void AS7341Mock::receive(const uint8_t *data, size_t len){
+  if(len == 0) return;
+  _pointer = data[0];
+  for(size_t i = 1; i < len; i++){write(_pointer++, data[i]);}
+}
+
+void AS7341Mock::request(uint8_t *data, size_t len){
+  for(size_t i = 0; i < len; i++){
+    if(_pointer == STATUS){statusreads++;}
+    data[i] = _regs[_pointer++];
+  }
+}
+
+void AS7341Mock::write(uint8_t r, uint8_t value){
+  if(r == STATUS){ //write-1-to-clear
+    _regs[STATUS] &= ~value;
+    updateInt();
+    return;
+  }
+  if(r == ID) return;
+  uint8_t old = _regs[r];
+  _regs[r] = value;
+  if(r == ENABLE){enableChanged(old);}
+  else if(r == INTENAB){updateInt();}
+}
+
+void AS7341Mock::enableChanged(uint8_t old){
+  uint8_t en = _regs[ENABLE];
+  if(!(en & PON)){en = 0; _regs[ENABLE] = 0;}
+  if((en & SMUXEN) && !(old & SMUXEN) && (_regs[CFG6] & 0x18) == 0x10){ //write SMUX chain from RAM
+    if(_smuxevent){hostCancel(_smuxevent);}
+    _smuxevent = hostAt(hostMicros() + 200, [this]{smuxDone();});
+  }
+  if((en & SP_EN) && !(old & SP_EN)){
+    if(_integevent){hostCancel(_integevent);}
+    _integevent = hostAt(hostMicros() + integrationTime(), [this]{integrationDone();});
+  }
+  else if(!(en & SP_EN) && _integevent){ //stopped mid-integration
+    hostCancel(_integevent);
+    _integevent = 0;
+  }
+}
+
+void AS7341Mock::smuxDone(){
+  _smuxevent = 0;
+  _regs[ENABLE] &= ~SMUXEN;
+  _high = (_regs[0x00] == 0x00); //the F1-F4 chain starts 0x30, the F5-F8 one 0x00
+  smuxcommands++;
+  if(_regs[CFG9] & 0x10){_regs[STATUS] |= SINT;}
+  updateInt();
+}
+
+void AS7341Mock::integrationDone(){
+  _integevent = 0;
+  bool lit = hostPin(16) || ((_regs[0x74] & 0x80) && (_regs[0x70] & 0x08));
+  uint32_t astep = _regs[ASTEP_L] | (_regs[ASTEP_H] << 8);
+  uint32_t steps = (uint32_t)(_regs[ATIME] + 1) * (astep + 1);
+  uint32_t fullscale = (steps > 65535) ? 65535 : steps;
+  uint8_t again = _regs[CFG1] & 0x1F;
+  float gain = (again == 0) ? 0.5f : (float)(1UL << (again - 1));
+  bool saturated = false;
+  for(uint8_t c = 0; c < 6; c++){
+    float nm = wavelengths[_high][c];
+    float irradiance = 0;
+    if(nm == 0){ //CLEAR, the visible band as a whole
+      for(uint8_t f = 0; f < 4; f++){irradiance += hostIrradiance(wavelengths[0][f], hostMicros(), lit) + hostIrradiance(wavelengths[1][f], hostMicros(), lit);}
+      irradiance /= 4;
+    }
+    else{
+      irradiance = hostIrradiance(nm, hostMicros(), lit);
+    }
+    float counts = irradiance * countscale * gain * steps;
+    uint16_t value = (counts >= fullscale) ? fullscale : (uint16_t)counts;
+    if(counts >= fullscale){saturated = true;}
+    adc[_high][c] = value;
+    _regs[0x95 + c * 2] = value & 0xFF;
+    _regs[0x96 + c * 2] = value >> 8;
+  }
+  _regs[ASTATUS] = saturated ? 0x80 : 0x00;
+  lastlit = lit;
+  integrations++;
+  _regs[STATUS] |= AINT;
+  updateInt();
+  if(_regs[ENABLE] & SP_EN){ //keeps integrating until SP_EN is cleared
+    _integevent = hostAt(hostMicros() + integrationTime(), [this]{integrationDone();});
+  }
+}
+
+//INT is open drain, low while an enabled interrupt is pending
+void AS7341Mock::updateInt(){
+  bool active = _regs[STATUS] & _regs[INTENAB] & (SINT | AINT);
+  if(hostPin(_intPin) == active){hostSetPin(_intPin, !active);}
+}
@@ -0,0 +1,49 @@
+#ifndef _HOST_AS7341_MOCK_H
+#define _HOST_AS7341_MOCK_H
+
+#include <Wire.h>
+
+/*
+AS7341 register map on the I2C bus model, with the INT pin. Writes auto-increment from the register
+pointer, SMUX RAM is 0x00-0x13. Setting SMUXEN with the "write from RAM" command in CFG6 takes smuxtime us
+and raises SINT, setting SP_EN runs integrations of (ATIME+1)*(ASTEP+1)*2.78us that each latch six ADC
+channels for the loaded SMUX half and raise AINT. INT is pulled low while an enabled STATUS bit is set and
+released when the firmware writes it back (write-1-to-clear). Counts follow the scene (spectra.h) with the
+gain and integration, clipped at the ADC full scale with ASAT set.
+*/
+class AS7341Mock : public HostI2CDevice {
+public:
+  AS7341Mock(uint8_t intPin = 6);
+  uint8_t address() const override {return 0x39;}
+  void receive(const uint8_t *data, size_t len) override;
+  void request(uint8_t *data, size_t len) override;
+
+  uint8_t reg(uint8_t r) const {return _regs[r];}
+  bool high() const {return _high;} //the loaded SMUX chain is the F5-F8 one
+  uint64_t integrationTime() const; //us
+
+  uint32_t smuxcommands = 0;
+  uint32_t integrations = 0;
+  uint32_t statusreads = 0; //STATUS reads, the bus traffic the INT pin saves
+  bool lastlit = false;
+  uint16_t adc[2][6] = {}; //last counts latched for the F1-F4 and F5-F8 halves, ADC0-ADC5
+  float countscale = 0.05f; //counts per irradiance unit per gain per step
+
+  static const float wavelengths[2][6]; //ADC0-ADC5 for the F1-F4 and F5-F8 halves (CLEAR and NIR as 0/910)
+
+private:
+  void write(uint8_t r, uint8_t value);
+  void enableChanged(uint8_t old);
+  void smuxDone();
+  void integrationDone();
+  void updateInt();
+
+  uint8_t _regs[256] = {};
+  uint8_t _pointer = 0;
+  uint8_t _intPin;
+  bool _high = false;
+  uint32_t _smuxevent = 0;
+  uint32_t _integevent = 0;
+};
+
+#endif
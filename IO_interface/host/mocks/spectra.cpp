@@ -0,0 +1,21 @@
+#include "spectra.h"
+#include <math.h>
+
+HostScene hostscene = {550.0f, 2.0f, 60.0f, 0.02f, 1.0f, 0.01f};
+
+//deterministic noise in [-1, 1] for a wavelength and a moment
+static float noiseAt(float nm, uint64_t us){
+  uint32_t h = (uint32_t)(nm * 16) * 2654435761UL ^ (uint32_t)(us / 1000) * 2246822519UL;
+  h ^= h >> 15;
+  h *= 2246822519UL;
+  h ^= h >> 13;
+  return (h & 0xFFFF) / 32767.5f - 1.0f;
+}
+
+float hostIrradiance(float nm, uint64_t us, bool lit){
+  float peak = hostscene.peak + hostscene.drift * (us / 1e6f);
+  float d = (nm - peak) / hostscene.width;
+  float reflectance = 0.15f + 0.85f * expf(-0.5f * d * d);
+  float light = hostscene.ambient + (lit ? hostscene.led : 0.0f);
+  return light * reflectance * (1.0f + hostscene.noise * noiseAt(nm, us));
+}
@@ -0,0 +1,26 @@
+#ifndef _HOST_SPECTRA_H
+#define _HOST_SPECTRA_H
+
+#include <stdint.h>
+
+/*
+Synthetic sample for the sensor mocks: a reflectance peak that drifts in wavelength over time (a banana
+going from green towards red), seen under ambient light plus the LEDs when they are on. Irradiance is in
+arbitrary units, about 1.0 at the peak with the LEDs on; each mock scales it to its own counts.
+A small deterministic noise term keeps bursts and auto-exposure honest without making runs differ.
+*/
+struct HostScene {
+  float peak; //nm at time 0
+  float drift; //nm per second
+  float width; //nm, gaussian sigma of the reflectance peak
+  float ambient; //irradiance with the LEDs off
+  float led; //extra irradiance with the LEDs on
+  float noise; //relative noise amplitude
+};
+
+extern HostScene hostscene;
+
+//irradiance at wavelength nm, at time us, with or without the LEDs
+float hostIrradiance(float nm, uint64_t us, bool lit);
+
+#endif
@@ -0,0 +1,157 @@
+/*
+Device simulator: the whole firmware (setup()/loop() on core0, setup1()/loop1() on core1) on the host board,
+with a sensor model on the I2C bus, the panel modelled at the controller RAM level, and the button and
+encoder driven from a script in virtual time.
+
+  simulator [-s none|as7265x|as7341] [-o dir] [-q] script
+
+Script lines are "<ms> <command> [argument]", # starts a comment:
+  press / release   measure button down / up
+  click             press, release 100ms later
+  turn              one encoder detent: next sense mode
+  led               one encoder detent with the encoder button held: next LED mode
+  dump <name>       the panel as it looks now to <dir>/<name>.pbm
+  peak <nm>         moves the scene's reflectance peak to nm (it keeps drifting from there)
+  drift <nm/s>      scene peak drift
+  end               stops the run (default: 2s after the last line)
+
+Serial goes to stdout (-q: only the summary). Same script, same output, every run.
+*/
+#include <spectroscopico.h>
+#include <IO_handler.h>
+#include <stdio.h>
+#include <string>
+#include "as7265x_mock.h"
+#include "as7341_mock.h"
+#include "spectra.h"
+#include "host.h"
+
+static const uint64_t LOOP_US = 10; //charged per loop()/loop1() call, the cost of the firmware's idle pass
+
+static std::string outdir = ".";
+static uint64_t endtime = 0; //2s after the last scripted event
+static uint64_t scriptend = 0; //the script's end line, wins over endtime
+static AS7265xMock as7265xmock;
+static AS7341Mock as7341mock;
+
+static void core1(){
+  setup1();
+  for(;;){
+    loop1();
+    hostAdvance(LOOP_US);
+  }
+}
+
+//one encoder detent: an edge on A, read with ENC_BTN as it is at the time
+static void detent(){
+  hostSetPin(ENC_PIN_A, !hostPin(ENC_PIN_A));
+}
+
+static bool command(uint64_t ms, const std::string &cmd, const std::string &arg){
+  uint64_t at = ms * 1000;
+  if(cmd == "press"){hostAt(at, []{hostSetPin(BTN_PIN, LOW);});}
+  else if(cmd == "release"){hostAt(at, []{hostSetPin(BTN_PIN, HIGH);});}
+  else if(cmd == "click"){
+    hostAt(at, []{hostSetPin(BTN_PIN, LOW);});
+    hostAt(at + 100000, []{hostSetPin(BTN_PIN, HIGH);});
+  }
+  else if(cmd == "turn"){hostAt(at, detent);}
+  else if(cmd == "led"){
+    hostAt(at, []{hostSetPin(ENC_BTN, LOW); detent();});
+    hostAt(at + 100000, []{hostSetPin(ENC_BTN, HIGH);});
+  }
+  else if(cmd == "dump" && !arg.empty()){
+    std::string path = outdir + "/" + arg + ".pbm";
+    hostAt(at, [path]{
+      if(!display.epd2.hostWritePBM(path.c_str())){fprintf(stderr, "cannot write %s\n", path.c_str());}
+    });
+  }
+  else if(cmd == "peak" && !arg.empty()){
+    float nm = atof(arg.c_str());
+    hostAt(at, [nm]{hostscene.peak = nm - hostscene.drift * hostMicros() / 1e6f;});
+  }
+  else if(cmd == "drift" && !arg.empty()){
+    float drift = atof(arg.c_str());
+    hostAt(at, [drift]{ //keeps the peak where it is now
+      float now = hostMicros() / 1e6f;
+      hostscene.peak += (hostscene.drift - drift) * now;
+      hostscene.drift = drift;
+    });
+  }
+  else if(cmd == "end"){scriptend = at;}
+  else return false;
+  if(at + 2000000 > endtime){endtime = at + 2000000;}
+  return true;
+}
+
+static bool loadScript(const char *path){
+  FILE *f = fopen(path, "r");
+  if(!f){
+    fprintf(stderr, "cannot open %s\n", path);
+    return false;
+  }
+  char line[256];
+  int n = 0;
+  bool ok = true;
+  while(fgets(line, sizeof(line), f)){
+    n++;
+    char *hash = strchr(line, '#');
+    if(hash){*hash = 0;}
+    unsigned long long ms;
+    char cmd[32], arg[128] = "";
+    int fields = sscanf(line, "%llu %31s %127s", &ms, cmd, arg);
+    if(fields <= 0) continue; //blank or comment
+    if(fields < 2 || !command(ms, cmd, arg)){
+      fprintf(stderr, "%s:%d: bad line\n", path, n);
+      ok = false;
+    }
+  }
+  fclose(f);
+  if(scriptend){endtime = scriptend;}
+  return ok;
+}
+
+int main(int argc, char **argv){
+  const char *sensorname = "none";
+  const char *script = nullptr;
+  bool quiet = false;
+  for(int i = 1; i < argc; i++){
+    if(!strcmp(argv[i], "-s") && i + 1 < argc){sensorname = argv[++i];}
+    else if(!strcmp(argv[i], "-o") && i + 1 < argc){outdir = argv[++i];}
+    else if(!strcmp(argv[i], "-q")){quiet = true;}
+    else if(argv[i][0] != '-' && !script){script = argv[i];}
+    else{
+      fprintf(stderr, "usage: %s [-s none|as7265x|as7341] [-o dir] [-q] script\n", argv[0]);
+      return 2;
+    }
+  }
+  if(!script){
+    fprintf(stderr, "usage: %s [-s none|as7265x|as7341] [-o dir] [-q] script\n", argv[0]);
+    return 2;
+  }
+  if(!strcmp(sensorname, "as7265x")){Wire.hostAttach(&as7265xmock);}
+  else if(!strcmp(sensorname, "as7341")){Wire.hostAttach(&as7341mock);}
+  else if(strcmp(sensorname, "none")){
+    fprintf(stderr, "unknown sensor %s\n", sensorname);
+    return 2;
+  }
+  if(!loadScript(script)) return 2;
+  hostSerialEcho = !quiet;
+
+  hostStartCore1(core1);
+  setup();
+  while(hostMicros() < endtime){
+    loop();
+    hostAdvance(LOOP_US);
+  }
+  hostStop();
+
+  const HostEPDStats &epd = display.epd2.stats;
+  printf("--\n%s, %s: %.3fs\n", script, sensorname, hostMicros() / 1e6);
+  printf("frames drawn %u, dropped %u\n", framesdrawn, framesdropped());
+  printf("refreshes full %u, partial %u, %u pixels; %u image bytes; %.3fs busy\n", epd.fullrefreshes,
+         epd.partialrefreshes, epd.refreshpixels, epd.bytes, epd.busytime / 1e6);
+  printf("i2c %u transfers, %u nacks, %.3fs; blocking calls in interrupts %u\n", Wire.stats.transfers,
+         Wire.stats.nacks, Wire.stats.time / 1e6, hostirqblocking);
+  return hostirqblocking ? 1 : 0;
+}
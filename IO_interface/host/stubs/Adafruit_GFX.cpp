@@ -0,0 +1,369 @@
+#include <Adafruit_GFX.h>
+
+extern uint8_t hostClassicFont[256 * 5]; //glyphs.cpp
+
+static inline void swap16(int16_t &a, int16_t &b){
+  int16_t t = a;
+  a = b;
+  b = t;
+}
+
+/*
+Adafruit_GFX
+*/
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+//Bresenham, as Adafruit_GFX::writeLine()
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+  if(x0 == x1){
+    if(y0 > y1){swap16(y0, y1);}
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    return;
+  }
+  if(y0 == y1){
+    if(x0 > x1){swap16(x0, x1);}
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    return;
+  }
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if(steep){
+    swap16(x0, y0);
+    swap16(x1, y1);
+  }
+  if(x0 > x1){
+    swap16(x0, x1);
+    swap16(y0, y1);
+  }
+  int16_t dx = x1 - x0;
+  int16_t dy = abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = (y0 < y1) ? 1 : -1;
+  for(; x0 <= x1; x0++){
+    if(steep){drawPixel(y0, x0, color);}
+    else{drawPixel(x0, y0, color);}
+    err -= dy;
+    if(err < 0){
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+//the base class draws spans as lines from the first to the last pixel, a negative length goes the other way
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color){
+  int16_t y1 = y + h - 1;
+  if(y > y1){swap16(y, y1);}
+  for(int16_t i = y; i <= y1; i++){drawPixel(x, i, color);}
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color){
+  int16_t x1 = x + w - 1;
+  if(x > x1){swap16(x, x1);}
+  for(int16_t i = x; i <= x1; i++){drawPixel(i, y, color);}
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  for(int16_t i = x; i < x + w; i++){drawFastVLine(i, y, h, color);}
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color){
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::setRotation(uint8_t r){
+  rotation = r & 3;
+  bool portrait = (rotation & 1) == 0;
+  _width = portrait ? WIDTH : HEIGHT;
+  _height = portrait ? HEIGHT : WIDTH;
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color){
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+  for(int16_t j = 0; j < h; j++, y++){
+    for(int16_t i = 0; i < w; i++){
+      if(i & 7){b <<= 1;}
+      else{b = bitmap[j * byteWidth + i / 8];}
+      if(b & 0x80){drawPixel(x + i, y, color);}
+    }
+  }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg){
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+  for(int16_t j = 0; j < h; j++, y++){
+    for(int16_t i = 0; i < w; i++){
+      if(i & 7){b <<= 1;}
+      else{b = bitmap[j * byteWidth + i / 8];}
+      drawPixel(x + i, y, (b & 0x80) ? color : bg);
+    }
+  }
+}
+
+/*
+Text
+*/
+void Adafruit_GFX::setFont(const GFXfont *f){
+  if(f){
+    if(!gfxFont){cursor_y += 6;} //custom fonts are drawn from the baseline, the classic one from the top
+  }
+  else if(gfxFont){
+    cursor_y -= 6;
+  }
+  gfxFont = f;
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y){
+  if(!gfxFont){ //classic 5x7 in a 6x8 cell
+    if((x >= _width) || (y >= _height) || ((x + 6 * size_x - 1) < 0) || ((y + 8 * size_y - 1) < 0)) return;
+    if(c >= 176){c++;} //the library's off-by-one in the classic font, kept for the same layout
+    for(int8_t i = 0; i < 5; i++){
+      uint8_t line = hostClassicFont[c * 5 + i];
+      for(int8_t j = 0; j < 8; j++, line >>= 1){
+        if(line & 1){
+          if(size_x == 1 && size_y == 1){drawPixel(x + i, y + j, color);}
+          else{fillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);}
+        }
+        else if(bg != color){
+          if(size_x == 1 && size_y == 1){drawPixel(x + i, y + j, bg);}
+          else{fillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);}
+        }
+      }
+    }
+    if(bg != color){
+      if(size_x == 1 && size_y == 1){drawFastVLine(x + 5, y, 8, bg);}
+      else{fillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);}
+    }
+    return;
+  }
+
+  c -= gfxFont->first;
+  const GFXglyph *glyph = &gfxFont->glyph[c];
+  const uint8_t *bitmap = gfxFont->bitmap;
+  uint16_t bo = glyph->bitmapOffset;
+  uint8_t w = glyph->width, h = glyph->height;
+  int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+  uint8_t bits = 0, bit = 0;
+  for(uint8_t yy = 0; yy < h; yy++){
+    for(uint8_t xx = 0; xx < w; xx++){
+      if(!(bit++ & 7)){bits = bitmap[bo++];}
+      if(bits & 0x80){
+        if(size_x == 1 && size_y == 1){drawPixel(x + xo + xx, y + yo + yy, color);}
+        else{fillRect(x + (xo + xx) * size_x, y + (yo + yy) * size_y, size_x, size_y, color);}
+      }
+      bits <<= 1;
+    }
+  }
+}
+
+size_t Adafruit_GFX::write(uint8_t c){
+  if(!gfxFont){
+    if(c == '\n'){
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    }
+    else if(c != '\r'){
+      if(wrap && ((cursor_x + textsize_x * 6) > _width)){
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+
+  if(c == '\n'){
+    cursor_x = 0;
+    cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+  }
+  else if(c != '\r' && c >= gfxFont->first && c <= gfxFont->last){
+    const GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+    if(glyph->width > 0 && glyph->height > 0){
+      int16_t xo = glyph->xOffset;
+      if(wrap && ((cursor_x + textsize_x * (xo + glyph->width)) > _width)){
+        cursor_x = 0;
+        cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+    }
+    cursor_x += glyph->xAdvance * (int16_t)textsize_x;
+  }
+  return 1;
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy){
+  if(!gfxFont){
+    if(c == '\n'){
+      *x = 0;
+      *y += textsize_y * 8;
+    }
+    else if(c != '\r'){
+      if(wrap && ((*x + textsize_x * 6) > _width)){
+        *x = 0;
+        *y += textsize_y * 8;
+      }
+      int16_t x2 = *x + textsize_x * 6 - 1, y2 = *y + textsize_y * 8 - 1;
+      if(x2 > *maxx){*maxx = x2;}
+      if(y2 > *maxy){*maxy = y2;}
+      if(*x < *minx){*minx = *x;}
+      if(*y < *miny){*miny = *y;}
+      *x += textsize_x * 6;
+    }
+    return;
+  }
+
+  if(c == '\n'){
+    *x = 0;
+    *y += textsize_y * gfxFont->yAdvance;
+  }
+  else if(c != '\r' && c >= gfxFont->first && c <= gfxFont->last){
+    const GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+    uint8_t gw = glyph->width, gh = glyph->height, xa = glyph->xAdvance;
+    int8_t xo = glyph->xOffset, yo = glyph->yOffset;
+    if(wrap && ((*x + (((int16_t)xo + gw) * textsize_x)) > _width)){
+      *x = 0;
+      *y += textsize_y * gfxFont->yAdvance;
+    }
+    int16_t x1 = *x + xo * textsize_x, y1 = *y + yo * textsize_y;
+    int16_t x2 = x1 + gw * textsize_x - 1, y2 = y1 + gh * textsize_y - 1;
+    if(x1 < *minx){*minx = x1;}
+    if(y1 < *miny){*miny = y1;}
+    if(x2 > *maxx){*maxx = x2;}
+    if(y2 > *maxy){*maxy = y2;}
+    *x += xa * textsize_x;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h){
+  int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+  *x1 = x;
+  *y1 = y;
+  *w = *h = 0;
+  unsigned char c;
+  while((c = *str++)){charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);}
+  if(maxx >= minx){
+    *x1 = minx;
+    *w = maxx - minx + 1;
+  }
+  if(maxy >= miny){
+    *y1 = miny;
+    *h = maxy - miny + 1;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h){
+  getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+}
+
+/*
+GFXcanvas1
+*/
+GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
+  size_t bytes = ((w + 7) / 8) * h;
+  buffer = (uint8_t *)malloc(bytes);
+  memset(buffer, 0, bytes);
+}
+
+GFXcanvas1::~GFXcanvas1(){
+  free(buffer);
+}
+
+void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color){
+  if((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) return;
+  int16_t t;
+  switch(rotation){
+    case 1:
+      t = x;
+      x = WIDTH - 1 - y;
+      y = t;
+      break;
+    case 2:
+      x = WIDTH - 1 - x;
+      y = HEIGHT - 1 - y;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = HEIGHT - 1 - t;
+      break;
+  }
+  uint8_t *ptr = &buffer[(x / 8) + y * ((WIDTH + 7) / 8)];
+  if(color){*ptr |= 0x80 >> (x & 7);}
+  else{*ptr &= ~(0x80 >> (x & 7));}
+}
+
+bool GFXcanvas1::getRawPixel(int16_t x, int16_t y) const {
+  if((x < 0) || (y < 0) || (x >= WIDTH) || (y >= HEIGHT)) return 0;
+  return buffer[(x / 8) + y * ((WIDTH + 7) / 8)] & (0x80 >> (x & 7));
+}
+
+bool GFXcanvas1::getPixel(int16_t x, int16_t y) const {
+  int16_t t;
+  switch(rotation){
+    case 1:
+      t = x;
+      x = WIDTH - 1 - y;
+      y = t;
+      break;
+    case 2:
+      x = WIDTH - 1 - x;
+      y = HEIGHT - 1 - y;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = HEIGHT - 1 - t;
+      break;
+  }
+  return getRawPixel(x, y);
+}
+
+void GFXcanvas1::fillScreen(uint16_t color){
+  memset(buffer, color ? 0xFF : 0x00, ((WIDTH + 7) / 8) * HEIGHT);
+}
+
+//the canvas spans take a negative length as the same span ending at (x, y), and a zero length as nothing
+void GFXcanvas1::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color){
+  if(h < 0){
+    h *= -1;
+    y -= h - 1;
+    if(y < 0){
+      h += y;
+      y = 0;
+    }
+  }
+  if((x < 0) || (x >= width()) || (y >= height()) || ((y + h - 1) < 0)) return;
+  if(y < 0){
+    h += y;
+    y = 0;
+  }
+  if(y + h > height()){h = height() - y;}
+  for(int16_t i = 0; i < h; i++){drawPixel(x, y + i, color);}
+}
+
+void GFXcanvas1::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color){
+  if(w < 0){
+    w *= -1;
+    x -= w - 1;
+    if(x < 0){
+      w += x;
+      x = 0;
+    }
+  }
+  if((y < 0) || (y >= height()) || (x >= width()) || ((x + w - 1) < 0)) return;
+  if(x < 0){
+    w += x;
+    x = 0;
+  }
+  if(x + w >= width()){w = width() - x;}
+  for(int16_t i = 0; i < w; i++){drawPixel(x + i, y, color);}
+}
@@ -0,0 +1,98 @@
+#ifndef _HOST_ADAFRUIT_GFX_H
+#define _HOST_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+/*
+The subset of Adafruit_GFX the firmware draws with, following the library's algorithms pixel for pixel
+(line stepping, clipping, GFXcanvas1 rotation and span semantics, text cursor and bounds). The fonts are
+not the library's: glyphs.cpp builds placeholder glyphs with the real fonts' metrics (advance, line height,
+ascent), so text lands where it does on the device but every character is a box with a per-character
+pattern. Screens rendered on the host are compared with host goldens, never with device photos.
+*/
+typedef struct {
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+} GFXglyph;
+
+typedef struct {
+  uint8_t *bitmap;
+  GFXglyph *glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+} GFXfont;
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  virtual ~Adafruit_GFX(){}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void setRotation(uint8_t r);
+
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+
+  void setCursor(int16_t x, int16_t y){cursor_x = x; cursor_y = y;}
+  void setTextColor(uint16_t c){textcolor = textbgcolor = c;}
+  void setTextColor(uint16_t c, uint16_t bg){textcolor = c; textbgcolor = bg;}
+  void setTextSize(uint8_t s){textsize_x = textsize_y = (s > 0) ? s : 1;}
+  void setTextWrap(bool w){wrap = w;}
+  void setFont(const GFXfont *f = nullptr);
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+  void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+
+  using Print::write;
+  size_t write(uint8_t c) override;
+
+  int16_t width() const {return _width;}
+  int16_t height() const {return _height;}
+  uint8_t getRotation() const {return rotation;}
+  int16_t getCursorX() const {return cursor_x;}
+  int16_t getCursorY() const {return cursor_y;}
+
+protected:
+  void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
+
+  int16_t WIDTH, HEIGHT; //as constructed, rotation 0
+  int16_t _width, _height; //as rotated
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+  uint8_t textsize_x = 1, textsize_y = 1;
+  uint8_t rotation = 0;
+  bool wrap = true;
+  const GFXfont *gfxFont = nullptr;
+};
+
+//1 bit per pixel in RAM, rows padded to whole bytes, MSB first, set bit = non-zero colour
+class GFXcanvas1 : public Adafruit_GFX {
+public:
+  GFXcanvas1(uint16_t w, uint16_t h);
+  ~GFXcanvas1();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  bool getPixel(int16_t x, int16_t y) const;
+  uint8_t *getBuffer() const {return buffer;}
+
+protected:
+  bool getRawPixel(int16_t x, int16_t y) const;
+
+private:
+  uint8_t *buffer;
+};
+
+#endif
@@ -0,0 +1,369 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "host.h"
+
+/*
+Virtual Time and Hardware Events
+*/
+static uint64_t clock_us[2];
+static std::map<std::pair<uint64_t, uint32_t>, std::function<void()>> events; //(time, id), in delivery order
+static uint32_t nextevent = 1;
+static bool inirq[2];
+static int irqdisabled[2]; //noInterrupts() depth
+uint32_t hostirqblocking = 0;
+
+struct Pin {
+  uint8_t mode;
+  bool level;
+  void (*handler)();
+  int irqmode;
+};
+static Pin pins[30];
+static std::vector<void (*)()> pendingirqs; //pin interrupts raised while core0 could not take them
+
+/*
+Cores. Each core is a thread, but only one holds the baton and runs at a time. A core that gets a quantum
+ahead of the other in virtual time hands the baton over and waits until the other one is ahead in turn,
+so the two interleave in virtual time order (to within the quantum) and a run is as deterministic as a
+single core one. The quantum only saves thread switches, it is well below anything the firmware times.
+*/
+static const uint64_t QUANTUM = 100; //us
+struct HostStop {}; //unwinds core1 when the run is stopped
+
+static thread_local int thiscore = 0;
+static bool core1started = false;
+static bool stopping = false;
+static int baton = 0;
+static std::mutex batonlock;
+static std::condition_variable batonwait;
+static std::thread core1thread;
+
+int hostCore(){
+  return thiscore;
+}
+
+uint64_t hostMicros(){
+  return clock_us[thiscore];
+}
+
+bool hostInIrq(){
+  return inirq[thiscore];
+}
+
+//waits for the baton, core1 leaves through HostStop once the run is stopped
+static void takeBaton(std::unique_lock<std::mutex> &lock){
+  batonwait.wait(lock, []{return baton == thiscore;});
+  if(stopping && thiscore == 1){throw HostStop();}
+}
+
+//lets the other core run once this one is a quantum ahead
+static void balance(){
+  if(!core1started) return;
+  int other = 1 - thiscore;
+  if(clock_us[thiscore] < clock_us[other] + QUANTUM) return;
+  std::unique_lock<std::mutex> lock(batonlock);
+  baton = other;
+  batonwait.notify_all();
+  takeBaton(lock);
+}
+
+void hostStartCore1(void (*entry)()){
+  if(core1started) return;
+  core1started = true;
+  clock_us[1] = clock_us[0];
+  core1thread = std::thread([entry]{
+    thiscore = 1;
+    try{
+      {
+        std::unique_lock<std::mutex> lock(batonlock);
+        takeBaton(lock);
+      }
+      entry();
+      hostFault("core1 entry returned");
+    }
+    catch(HostStop &){}
+  });
+}
+
+void hostStop(){
+  if(!core1started || thiscore != 0) return;
+  {
+    std::lock_guard<std::mutex> lock(batonlock);
+    stopping = true;
+    baton = 1;
+  }
+  batonwait.notify_all();
+  core1thread.join();
+  core1started = false;
+  stopping = false;
+  baton = 0;
+}
+
+//runs an interrupt handler on core0, then any pin interrupts it raised
+static void runIrq(const std::function<void()> &handler){
+  inirq[0] = true;
+  handler();
+  while(!pendingirqs.empty()){
+    void (*h)() = pendingirqs.front();
+    pendingirqs.erase(pendingirqs.begin());
+    h();
+  }
+  inirq[0] = false;
+}
+
+static bool canInterrupt(){
+  return thiscore == 0 && !inirq[0] && !irqdisabled[0];
+}
+
+//delivers everything due by core0's clock, unless interrupts are masked or one is already running
+static void deliverDue(){
+  if(canInterrupt() && !pendingirqs.empty()){runIrq([]{});}
+  while(canInterrupt() && !events.empty() && events.begin()->first.first <= clock_us[0]){
+    auto next = events.begin();
+    std::function<void()> event = next->second;
+    events.erase(next);
+    runIrq(event);
+  }
+}
+
+//core0 stops at every event on the way so it is delivered on time, either core hands over to the other
+//whenever it gets ahead
+void hostAdvance(uint64_t us){
+  uint64_t target = clock_us[thiscore] + us;
+  for(;;){
+    deliverDue();
+    uint64_t step = target;
+    if(canInterrupt() && !events.empty() && events.begin()->first.first < step){step = events.begin()->first.first;}
+    if(clock_us[thiscore] < step){clock_us[thiscore] = step;}
+    deliverDue();
+    balance();
+    if(clock_us[thiscore] >= target) break;
+  }
+}
+
+uint32_t hostAt(uint64_t us, std::function<void()> event){
+  uint32_t id = nextevent++;
+  events[std::make_pair(us, id)] = event;
+  return id;
+}
+
+void hostCancel(uint32_t id){
+  for(auto i = events.begin(); i != events.end(); ++i){
+    if(i->first.second == id){
+      events.erase(i);
+      return;
+    }
+  }
+}
+
+void hostFault(const char *what){
+  fprintf(stderr, "firmware fault at %llu us on core %d%s: %s\n", (unsigned long long)hostMicros(), hostCore(),
+          hostInIrq() ? " (interrupt)" : "", what);
+  fflush(stdout);
+  _Exit(3); //the other core's thread is still parked on the baton
+}
+
+/*
+Pins and Interrupts
+*/
+void pinMode(uint8_t pin, uint8_t mode){
+  if(pin >= 30) return;
+  pins[pin].mode = mode;
+  if(mode == INPUT_PULLUP){pins[pin].level = HIGH;}
+  else if(mode == INPUT_PULLDOWN){pins[pin].level = LOW;}
+}
+
+void digitalWrite(uint8_t pin, uint8_t level){
+  if(pin < 30){pins[pin].level = level;}
+}
+
+int digitalRead(uint8_t pin){
+  return (pin < 30) ? pins[pin].level : LOW;
+}
+
+int analogRead(uint8_t){
+  return 0;
+}
+
+void hostSetPin(uint8_t pin, bool level){
+  if(pin >= 30) return;
+  Pin &p = pins[pin];
+  bool old = p.level;
+  p.level = level;
+  if(!p.handler || old == level) return;
+  if(p.irqmode == FALLING && level) return;
+  if(p.irqmode == RISING && !level) return;
+  if(!canInterrupt()){pendingirqs.push_back(p.handler);} //core0 takes it when it next can
+  else{runIrq(p.handler);}
+}
+
+bool hostPin(uint8_t pin){
+  return (pin < 30) ? pins[pin].level : false;
+}
+
+int digitalPinToInterrupt(int pin){
+  return pin;
+}
+
+void attachInterrupt(int irq, void (*handler)(), int mode){
+  if(irq < 0 || irq >= 30) return;
+  pins[irq].handler = handler;
+  pins[irq].irqmode = mode;
+}
+
+void detachInterrupt(int irq){
+  if(irq >= 0 && irq < 30){pins[irq].handler = nullptr;}
+}
+
+void noInterrupts(){
+  irqdisabled[thiscore]++;
+}
+
+void interrupts(){
+  if(irqdisabled[thiscore]){irqdisabled[thiscore]--;}
+  if(canInterrupt() && !pendingirqs.empty()){runIrq([]{});}
+}
+
+/*
+Time
+*/
+unsigned long millis(){
+  return (unsigned long)(hostMicros() / 1000);
+}
+
+unsigned long micros(){
+  return (unsigned long)hostMicros();
+}
+
+void delay(unsigned long ms){
+  hostAdvance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us){
+  hostAdvance(us);
+}
+
+RP2040 rp2040;
+
+uint32_t RP2040::getCycleCount(){
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void yield(){
+  hostAdvance(1); //a loop spinning on yield() still lets time pass
+}
+
+void hostReset(){
+  hostStop();
+  clock_us[0] = 0;
+  clock_us[1] = 0;
+  events.clear();
+  pendingirqs.clear();
+  memset(inirq, 0, sizeof(inirq));
+  memset(irqdisabled, 0, sizeof(irqdisabled));
+  hostirqblocking = 0;
+  memset(pins, 0, sizeof(pins));
+  hostSerialClear();
+  randomSeed(1);
+}
+
+/*
+Random (deterministic, so generated frames are the same on every run)
+*/
+static uint32_t randomstate = 1;
+
+void randomSeed(unsigned long seed){
+  if(seed != 0){randomstate = seed;}
+}
+
+long random(long max){
+  if(max <= 0) return 0;
+  randomstate = randomstate * 1103515245UL + 12345UL;
+  return (randomstate >> 8) % max;
+}
+
+long random(long min, long max){
+  if(min >= max) return min;
+  return min + random(max - min);
+}
+
+spi_inst_t *spi0 = nullptr;
+spi_inst_t *spi1 = nullptr;
+
+/*
+String
+*/
+static std::string formatNumber(unsigned long v, unsigned char base){
+  if(base < 2 || base > 16){base = 10;}
+  char buf[8 * sizeof(v) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = 0;
+  do{
+    *--p = "0123456789ABCDEF"[v % base];
+    v /= base;
+  } while(v);
+  return p;
+}
+
+static std::string formatFloat(double v, int decimals){
+  if(isnan(v)) return "nan";
+  if(isinf(v)) return "inf";
+  if(v > 4294967040.0 || v < -4294967040.0) return "ovf";
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+  return buf;
+}
+
+String::String(unsigned char v, unsigned char base) : _s(formatNumber(v, base)) {}
+String::String(int v, unsigned char base) : String((long)v, base) {}
+String::String(unsigned int v, unsigned char base) : _s(formatNumber(v, base)) {}
+String::String(long v, unsigned char base)
+  : _s((base == 10 && v < 0) ? "-" + formatNumber(-(unsigned long)v, 10) : formatNumber((unsigned long)v, base)) {}
+String::String(unsigned long v, unsigned char base) : _s(formatNumber(v, base)) {}
+String::String(float v, unsigned char decimals) : _s(formatFloat(v, decimals)) {}
+String::String(double v, unsigned char decimals) : _s(formatFloat(v, decimals)) {}
+
+/*
+Print
+*/
+size_t Print::write(const uint8_t *buffer, size_t size){
+  size_t n = 0;
+  while(size--){n += write(*buffer++);}
+  return n;
+}
+
+size_t Print::print(const char *s){return write(s);}
+size_t Print::print(const String &s){return write(s.c_str());}
+size_t Print::print(char c){return write((uint8_t)c);}
+size_t Print::print(unsigned char v, int base){return print((unsigned long)v, base);}
+size_t Print::print(int v, int base){return print((long)v, base);}
+size_t Print::print(unsigned int v, int base){return print((unsigned long)v, base);}
+size_t Print::print(long v, int base){return print(String(v, (unsigned char)base));}
+size_t Print::print(unsigned long v, int base){return write(formatNumber(v, base).c_str());}
+size_t Print::print(double v, int decimals){return write(formatFloat(v, decimals).c_str());}
+size_t Print::println(){return write("\r\n");}
+
+static std::string seriallog;
+bool hostSerialEcho = false;
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c){
+  if(c == '\r') return 1; //logs are compared line by line, keep them in host line endings
+  seriallog += (char)c;
+  if(hostSerialEcho){putchar(c);}
+  return 1;
+}
+
+const std::string &hostSerial(){
+  return seriallog;
+}
+
+void hostSerialClear(){
+  seriallog.clear();
+}
@@ -0,0 +1,154 @@
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+/*
+Host build of the arduino-pico core, only the parts the firmware uses. Time is virtual: millis()/micros()
+read a clock that only moves when the firmware waits (delay, yield, bus transfers), so a run gives the
+same result every time and is independent of how fast the host is. See host.h for the test-side controls.
+*/
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define A0 26
+#define LED_BUILTIN 25
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define __not_in_flash_func(x) x
+
+/*
+String
+*/
+class String {
+public:
+  String(const char *s = "") : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  explicit String(char c) : _s(1, c) {}
+  String(unsigned char v, unsigned char base = DEC);
+  String(int v, unsigned char base = DEC);
+  String(unsigned int v, unsigned char base = DEC);
+  String(long v, unsigned char base = DEC);
+  String(unsigned long v, unsigned char base = DEC);
+  String(float v, unsigned char decimals = 2);
+  String(double v, unsigned char decimals = 2);
+
+  const char *c_str() const {return _s.c_str();}
+  unsigned int length() const {return _s.length();}
+  char operator[](unsigned int i) const {return i < _s.length() ? _s[i] : 0;}
+  String &operator+=(const String &o){_s += o._s; return *this;}
+  String &operator+=(const char *o){_s += o; return *this;}
+  String &operator+=(char c){_s += c; return *this;}
+  bool operator==(const String &o) const {return _s == o._s;}
+  bool operator!=(const String &o) const {return _s != o._s;}
+  bool operator==(const char *o) const {return _s == o;}
+  bool operator!=(const char *o) const {return _s != o;}
+
+  friend String operator+(const String &a, const String &b){return String(a._s + b._s);}
+  friend String operator+(const String &a, const char *b){return String(a._s + b);}
+  friend String operator+(const char *a, const String &b){return String(a + b._s);}
+
+private:
+  std::string _s;
+};
+
+/*
+Print and Serial
+*/
+class Print {
+public:
+  virtual ~Print(){}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *s){return write((const uint8_t *)s, strlen(s));}
+
+  size_t print(const char *s);
+  size_t print(const String &s);
+  size_t print(char c);
+  size_t print(unsigned char v, int base = DEC);
+  size_t print(int v, int base = DEC);
+  size_t print(unsigned int v, int base = DEC);
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int decimals = 2);
+
+  size_t println();
+  template <typename T> size_t println(T v){size_t n = print(v); return n + println();}
+  template <typename T> size_t println(T v, int format){size_t n = print(v, format); return n + println();}
+};
+
+//everything printed goes into hostSerial() (and stdout with hostSerialEcho set)
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long){}
+  operator bool(){return true;}
+  using Print::write;
+  size_t write(uint8_t c) override;
+};
+extern HardwareSerial Serial;
+
+/*
+Pins, time, interrupts
+*/
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+//rp2040.getCycleCount() for FIXEDPOINT_CYCLES: host nanoseconds (real time, not virtual), not RP2040 cycles
+class RP2040 {
+public:
+  uint32_t getCycleCount();
+};
+extern RP2040 rp2040;
+
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int irq, void (*handler)(), int mode);
+void detachInterrupt(int irq);
+void noInterrupts();
+void interrupts();
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+template <class T, class U> typename std::common_type<T, U>::type min(T a, U b){return (a < b) ? a : b;}
+template <class T, class U> typename std::common_type<T, U>::type max(T a, U b){return (a > b) ? a : b;}
+#define constrain(a, lo, hi) ((a) < (lo) ? (lo) : ((a) > (hi) ? (hi) : (a)))
+
+typedef struct spi_inst spi_inst_t;
+extern spi_inst_t *spi0;
+extern spi_inst_t *spi1;
+
+//the firmware's sketch entry points, defined in Firmware_v1_1.ino
+void setup();
+void loop();
+void setup1();
+void loop1();
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef _HOST_FREEMONOBOLD18PT7B_H
+#define _HOST_FREEMONOBOLD18PT7B_H
+
+#include <Adafruit_GFX.h>
+
+extern GFXfont FreeMonoBold18pt7b; //placeholder glyphs, real metrics (glyphs.cpp)
+
+#endif
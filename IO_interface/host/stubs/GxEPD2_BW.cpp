@@ -0,0 +1,208 @@
+#include <GxEPD2_BW.h>
+#include <stdio.h>
+#include "host.h"
+
+GxEPD2_213_GDEY0213B74::GxEPD2_213_GDEY0213B74(int16_t, int16_t, int16_t, int16_t){
+  memset(_current, 0xFF, RAM_BYTES);
+  memset(_previous, 0xFF, RAM_BYTES);
+  memset(_panel, 0xFF, RAM_BYTES);
+}
+
+void GxEPD2_213_GDEY0213B74::selectSPI(SPIClassRP2040 &, SPISettings settings){
+  _spiclock = settings.clock;
+}
+
+void GxEPD2_213_GDEY0213B74::init(uint32_t, bool initial, uint16_t, bool){
+  _initial_write = initial;
+  _initial_refresh = initial;
+  _power_is_on = false;
+}
+
+//data bytes on the SPI bus, 8 clocks each
+void GxEPD2_213_GDEY0213B74::_transfer(uint32_t bytes){
+  stats.bytes += bytes;
+  hostAdvance(((uint64_t)bytes * 8 * 1000000 + _spiclock - 1) / _spiclock);
+}
+
+void GxEPD2_213_GDEY0213B74::_busy(uint16_t ms){
+  stats.busytime += (uint64_t)ms * 1000;
+  hostAdvance((uint64_t)ms * 1000);
+}
+
+void GxEPD2_213_GDEY0213B74::_PowerOn(){
+  if(!_power_is_on){_busy(power_on_time);}
+  _power_is_on = true;
+}
+
+void GxEPD2_213_GDEY0213B74::writeScreenBuffer(uint8_t value){
+  if(_initial_write){ //both RAMs the first time, as the driver does
+    memset(_previous, value, RAM_BYTES);
+    _transfer(RAM_BYTES);
+    stats.previouswrites++;
+  }
+  _initial_write = false;
+  memset(_current, value, RAM_BYTES);
+  _transfer(RAM_BYTES);
+  stats.currentwrites++;
+}
+
+void GxEPD2_213_GDEY0213B74::clearScreen(uint8_t value){
+  writeScreenBuffer(value);
+  refresh(true);
+  memset(_previous, value, RAM_BYTES); //writeScreenBufferAgain()
+  _transfer(RAM_BYTES);
+  stats.previouswrites++;
+}
+
+//the driver's _writeImage(): x and w to whole bytes, clipped to the RAM, rows taken from the bitmap as laid out
+void GxEPD2_213_GDEY0213B74::_writeImage(uint8_t *ram, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y){
+  _initial_write = false;
+  int16_t wb = (w + 7) / 8;
+  x -= x % 8;
+  w = wb * 8;
+  int16_t x1 = x < 0 ? 0 : x;
+  int16_t y1 = y < 0 ? 0 : y;
+  int16_t w1 = x + w < (int16_t)WIDTH ? w : (int16_t)WIDTH - x;
+  int16_t h1 = y + h < (int16_t)HEIGHT ? h : (int16_t)HEIGHT - y;
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if((w1 <= 0) || (h1 <= 0)) return;
+  for(int16_t i = 0; i < h1; i++){
+    for(int16_t j = 0; j < w1 / 8; j++){
+      int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
+      uint8_t data = bitmap[idx];
+      ram[(y1 + i) * (WIDTH / 8) + x1 / 8 + j] = invert ? ~data : data;
+    }
+  }
+  _transfer((uint32_t)h1 * (w1 / 8));
+  if(ram == _current){stats.currentwrites++;}
+  else{stats.previouswrites++;}
+}
+
+//the driver's _writeImagePart(): a window of a larger bitmap
+void GxEPD2_213_GDEY0213B74::_writeImagePart(uint8_t *ram, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                             int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y){
+  _initial_write = false;
+  if((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if((x_part < 0) || (x_part >= w_bitmap)) return;
+  if((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8;
+  x_part -= x_part % 8;
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w;
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h;
+  x -= x % 8;
+  w = 8 * ((w + 7) / 8);
+  int16_t x1 = x < 0 ? 0 : x;
+  int16_t y1 = y < 0 ? 0 : y;
+  int16_t w1 = x + w < (int16_t)WIDTH ? w : (int16_t)WIDTH - x;
+  int16_t h1 = y + h < (int16_t)HEIGHT ? h : (int16_t)HEIGHT - y;
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if((w1 <= 0) || (h1 <= 0)) return;
+  for(int16_t i = 0; i < h1; i++){
+    for(int16_t j = 0; j < w1 / 8; j++){
+      int16_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap
+                             : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
+      uint8_t data = bitmap[idx];
+      ram[(y1 + i) * (WIDTH / 8) + x1 / 8 + j] = invert ? ~data : data;
+    }
+  }
+  _transfer((uint32_t)h1 * (w1 / 8));
+  if(ram == _current){stats.currentwrites++;}
+  else{stats.previouswrites++;}
+}
+
+void GxEPD2_213_GDEY0213B74::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool){
+  _writeImage(_current, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_213_GDEY0213B74::writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool){
+  _writeImage(_previous, bitmap, x, y, w, h, invert, mirror_y);
+  _writeImage(_current, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+//after a refresh the previous RAM has to match the panel for the next differential update
+void GxEPD2_213_GDEY0213B74::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool){
+  _writeImage(_previous, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_213_GDEY0213B74::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                            int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool){
+  _writeImagePart(_current, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_213_GDEY0213B74::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                                 int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool){
+  _writeImagePart(_previous, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+}
+
+//full refresh: the whole current RAM, the update sequence ends with the booster off
+void GxEPD2_213_GDEY0213B74::refresh(bool partial_update_mode){
+  if(partial_update_mode){
+    refresh(0, 0, WIDTH, HEIGHT);
+    return;
+  }
+  _PowerOn();
+  _busy(full_refresh_time);
+  memcpy(_panel, _current, RAM_BYTES);
+  stats.fullrefreshes++;
+  stats.refreshpixels += (uint32_t)WIDTH_VISIBLE * HEIGHT;
+  _power_is_on = false;
+  _initial_refresh = false;
+}
+
+//partial refresh of a window (x and w to whole bytes), the first refresh after init() has to be a full one
+void GxEPD2_213_GDEY0213B74::refresh(int16_t x, int16_t y, int16_t w, int16_t h){
+  if(_initial_refresh){
+    refresh(false);
+    return;
+  }
+  int16_t x1 = x < 0 ? 0 : x;
+  int16_t y1 = y < 0 ? 0 : y;
+  int16_t x2 = x + w < (int16_t)WIDTH ? x + w : WIDTH;
+  int16_t y2 = y + h < (int16_t)HEIGHT ? y + h : HEIGHT;
+  x1 -= x1 % 8;
+  x2 = ((x2 + 7) / 8) * 8;
+  if(x2 > (int16_t)WIDTH){x2 = WIDTH;}
+  if(x1 >= x2 || y1 >= y2) return;
+  _PowerOn();
+  _busy(partial_refresh_time);
+  for(int16_t row = y1; row < y2; row++){
+    memcpy(&_panel[row * (WIDTH / 8) + x1 / 8], &_current[row * (WIDTH / 8) + x1 / 8], (x2 - x1) / 8);
+  }
+  stats.partialrefreshes++;
+  stats.refreshpixels += (uint32_t)(min(x2, (int16_t)WIDTH_VISIBLE) - x1) * (y2 - y1);
+}
+
+void GxEPD2_213_GDEY0213B74::powerOff(){
+  if(_power_is_on){
+    _busy(power_off_time);
+    stats.poweroffs++;
+  }
+  _power_is_on = false;
+}
+
+void GxEPD2_213_GDEY0213B74::hibernate(){
+  powerOff();
+}
+
+bool GxEPD2_213_GDEY0213B74::hostWritePBM(const char *path) const {
+  FILE *f = fopen(path, "wb");
+  if(!f) return false;
+  fprintf(f, "P4\n%d %d\n", HEIGHT, WIDTH_VISIBLE);
+  for(int16_t y = 0; y < (int16_t)WIDTH_VISIBLE; y++){ //landscape (x, y) is panel (WIDTH_VISIBLE - 1 - y, x)
+    uint8_t row[(HEIGHT + 7) / 8] = {};
+    int16_t px = WIDTH_VISIBLE - 1 - y;
+    for(int16_t x = 0; x < (int16_t)HEIGHT; x++){
+      bool white = _panel[x * (WIDTH / 8) + px / 8] & (0x80 >> (px % 8));
+      if(!white){row[x / 8] |= 0x80 >> (x % 8);}
+    }
+    fwrite(row, 1, sizeof(row), f);
+  }
+  fclose(f);
+  return true;
+}
@@ -0,0 +1,159 @@
+#ifndef _HOST_GXEPD2_BW_H
+#define _HOST_GXEPD2_BW_H
+
+#include <Adafruit_GFX.h>
+#include <SPI.h>
+
+/*
+GxEPD2_BW and the GDEY0213B74 (SSD1680) driver, modelled at the controller RAM level. Image writes go to
+the current (0x24) and previous (0x26) RAMs with the driver's byte alignment and clipping, a refresh copies
+the current RAM to the panel (the refreshed window only, for a partial one), and each step costs its SPI
+bytes (4MHz) and the driver's busy time on the clock. The stats and the panel image are what the host
+tests and the simulator check.
+*/
+#define GxEPD_WHITE 0xFFFF
+#define GxEPD_BLACK 0x0000
+
+struct HostEPDStats {
+  uint32_t bytes; //image bytes sent, both RAMs
+  uint32_t currentwrites; //image writes to 0x24
+  uint32_t previouswrites; //image writes to 0x26
+  uint32_t fullrefreshes;
+  uint32_t partialrefreshes;
+  uint32_t refreshpixels; //area of the refreshes (full ones count the whole panel)
+  uint32_t poweroffs; //powerOff() calls that switched the booster off
+  uint64_t busytime; //us spent waiting on BUSY
+};
+
+class GxEPD2_213_GDEY0213B74 {
+public:
+  static const uint16_t WIDTH = 128; //controller RAM
+  static const uint16_t WIDTH_VISIBLE = 122;
+  static const uint16_t HEIGHT = 250;
+  static const bool hasFastPartialUpdate = true;
+  static const uint16_t power_on_time = 100; //ms
+  static const uint16_t power_off_time = 250;
+  static const uint16_t full_refresh_time = 4000;
+  static const uint16_t partial_refresh_time = 750;
+  static const size_t RAM_BYTES = WIDTH / 8 * HEIGHT;
+
+  GxEPD2_213_GDEY0213B74(int16_t cs, int16_t dc, int16_t rst, int16_t busy);
+  void selectSPI(SPIClassRP2040 &spi, SPISettings settings);
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration, bool pulldown_rst_mode);
+
+  void clearScreen(uint8_t value = 0xFF);
+  void writeScreenBuffer(uint8_t value = 0xFF);
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                      int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                           int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+  void refresh(bool partial_update_mode = false);
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h);
+  void powerOff();
+  void hibernate();
+
+  //host side
+  HostEPDStats stats = {};
+  const uint8_t *panel() const {return _panel;} //what the panel shows, RAM layout, 1 = white
+  const uint8_t *currentRam() const {return _current;}
+  const uint8_t *previousRam() const {return _previous;}
+  bool poweredOn() const {return _power_is_on;}
+  //the panel as a binary PBM (P4, 1 = black), landscape as the firmware draws it (rotation 1)
+  bool hostWritePBM(const char *path) const;
+
+private:
+  void _writeImage(uint8_t *ram, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y);
+  void _writeImagePart(uint8_t *ram, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y);
+  void _transfer(uint32_t bytes);
+  void _busy(uint16_t ms);
+  void _PowerOn();
+
+  uint8_t _current[RAM_BYTES];
+  uint8_t _previous[RAM_BYTES];
+  uint8_t _panel[RAM_BYTES];
+  uint32_t _spiclock = 4000000;
+  bool _power_is_on = false;
+  bool _initial_write = true;
+  bool _initial_refresh = true;
+};
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance) : Adafruit_GFX(GxEPD2_Type::WIDTH_VISIBLE, GxEPD2_Type::HEIGHT), epd2(epd2_instance) {
+    setFullWindow();
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration, bool pulldown_rst_mode,
+            SPIClassRP2040 &spi, SPISettings settings){
+    epd2.selectSPI(spi, settings);
+    epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+    setFullWindow();
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
+    int16_t t;
+    switch(getRotation()){
+      case 1:
+        t = x; x = y; y = t;
+        x = WIDTH - x - 1;
+        break;
+      case 2:
+        x = WIDTH - x - 1;
+        y = HEIGHT - y - 1;
+        break;
+      case 3:
+        t = x; x = y; y = t;
+        y = HEIGHT - y - 1;
+        break;
+    }
+    x -= _pw_x;
+    y -= _pw_y;
+    if((x < 0) || (x >= (int16_t)_pw_w) || (y < 0) || (y >= (int16_t)_pw_h)) return;
+    if((y < 0) || (y >= (int16_t)page_height)) return;
+    uint16_t i = x / 8 + y * (_pw_w / 8);
+    if(color){_buffer[i] = (_buffer[i] | (1 << (7 - x % 8)));}
+    else{_buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));}
+  }
+
+  void fillScreen(uint16_t color) override {
+    memset(_buffer, (color == GxEPD_BLACK) ? 0x00 : 0xFF, sizeof(_buffer));
+  }
+
+  void setFullWindow(){
+    _pw_x = 0;
+    _pw_y = 0;
+    _pw_w = GxEPD2_Type::WIDTH;
+    _pw_h = GxEPD2_Type::HEIGHT;
+  }
+
+  void clearScreen(uint8_t value = 0xFF){
+    epd2.clearScreen(value);
+  }
+
+  //the whole buffer to the panel, as GxEPD2_BW::display() (single page only, page_height == HEIGHT)
+  void display(bool partial_update_mode = false){
+    static_assert(page_height == GxEPD2_Type::HEIGHT, "the host GxEPD2_BW only models a full-height buffer");
+    if(partial_update_mode){epd2.writeImage(_buffer, 0, 0, GxEPD2_Type::WIDTH, page_height);}
+    else{epd2.writeImageForFullRefresh(_buffer, 0, 0, GxEPD2_Type::WIDTH, page_height);}
+    epd2.refresh(partial_update_mode);
+    if(epd2.hasFastPartialUpdate){epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, page_height);}
+    if(!partial_update_mode){epd2.powerOff();}
+  }
+
+  void powerOff(){epd2.powerOff();}
+  void hibernate(){epd2.hibernate();}
+
+private:
+  uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+};
+
+#endif
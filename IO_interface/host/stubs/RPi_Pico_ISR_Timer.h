@@ -0,0 +1,6 @@
+#ifndef _HOST_RPI_PICO_ISR_TIMER_H
+#define _HOST_RPI_PICO_ISR_TIMER_H
+
+#include <RPi_Pico_TimerInterrupt.h>
+
+#endif
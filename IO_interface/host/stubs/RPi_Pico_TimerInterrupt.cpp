@@ -0,0 +1,42 @@
+#include <RPi_Pico_TimerInterrupt.h>
+#include "host.h"
+
+bool RPI_PICO_Timer::attachInterrupt(float frequency, pico_timer_callback callback){
+  if(frequency <= 0) return false;
+  return attachInterruptInterval((uint64_t)(1000000.0f / frequency), callback);
+}
+
+bool RPI_PICO_Timer::attachInterruptInterval(uint64_t interval_us, pico_timer_callback callback){
+  _callback = callback;
+  _period = interval_us;
+  _timer.delay_us = -(int64_t)interval_us;
+  enableTimer();
+  return true;
+}
+
+void RPI_PICO_Timer::detachInterrupt(){
+  disableTimer();
+  _callback = nullptr;
+}
+
+void RPI_PICO_Timer::disableTimer(){
+  if(_event){hostCancel(_event);}
+  _event = 0;
+}
+
+//restarts the period from now, as the library's enableTimer() re-adds the repeating timer
+void RPI_PICO_Timer::enableTimer(){
+  disableTimer();
+  if(_callback){schedule();}
+}
+
+void RPI_PICO_Timer::schedule(){
+  _event = hostAt(hostMicros() + _period, [this]{fire();});
+}
+
+void RPI_PICO_Timer::fire(){
+  uint32_t event = _event;
+  bool again = _callback(&_timer);
+  if(again && _event == event && _callback){schedule();} //not disabled or restarted by the callback
+  else if(_event == event){_event = 0;}
+}
@@ -0,0 +1,34 @@
+#ifndef _HOST_RPI_PICO_TIMERINTERRUPT_H
+#define _HOST_RPI_PICO_TIMERINTERRUPT_H
+
+#include <Arduino.h>
+
+struct repeating_timer {
+  int64_t delay_us;
+  void *user_data;
+};
+typedef bool (*pico_timer_callback)(struct repeating_timer *t);
+
+//hardware alarm repeating at a frequency in Hz, the callback runs in interrupt context (hostAt() events)
+//and the timer stops when it returns false or disableTimer() is called
+class RPI_PICO_Timer {
+public:
+  RPI_PICO_Timer(uint8_t timerNo){(void)timerNo;}
+  bool attachInterrupt(float frequency, pico_timer_callback callback);
+  bool attachInterruptInterval(uint64_t interval_us, pico_timer_callback callback);
+  void detachInterrupt();
+  void disableTimer();
+  void enableTimer();
+  bool enabled(){return _event != 0;}
+
+private:
+  void schedule();
+  void fire();
+
+  pico_timer_callback _callback = nullptr;
+  uint64_t _period = 0;
+  uint32_t _event = 0;
+  repeating_timer _timer = {};
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef _HOST_ROTARY_ENCODER_H
+#define _HOST_ROTARY_ENCODER_H
+
+//declared by the firmware but never constructed, the encoder is read through its pin interrupts
+class RotaryEncoder {
+public:
+  enum class LatchMode {FOUR3 = 1, FOUR0 = 2, TWO03 = 3};
+  RotaryEncoder(int pin1, int pin2, LatchMode mode = LatchMode::FOUR0){(void)pin1; (void)pin2; (void)mode;}
+  void tick(){}
+  long getPosition(){return 0;}
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include <Arduino.h>
+
+//the panel is modelled in GxEPD2_BW.h at the image level, the SPI object only carries the settings
+class SPISettings {
+public:
+  SPISettings(uint32_t clock = 4000000, uint8_t bitorder = 1, uint8_t datamode = 0) : clock(clock) {(void)bitorder; (void)datamode;}
+  uint32_t clock;
+};
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPIClassRP2040 {
+public:
+  SPIClassRP2040(spi_inst_t *spi, int rx, int cs, int sck, int tx){(void)spi; (void)rx; (void)cs; (void)sck; (void)tx;}
+  void begin(){}
+  void end(){}
+  void beginTransaction(SPISettings settings){_settings = settings;}
+  void endTransaction(){}
+  uint8_t transfer(uint8_t){return 0;}
+  SPISettings settings(){return _settings;}
+
+private:
+  SPISettings _settings;
+};
+
+#endif
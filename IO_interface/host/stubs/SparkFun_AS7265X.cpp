@@ -0,0 +1,214 @@
+#include <SparkFun_AS7265X.h>
+
+bool AS7265X::begin(TwoWire &wirePort){
+  _i2cPort = &wirePort;
+  if(!isConnected()) return false;
+  uint8_t value = virtualReadRegister(AS7265X_DEV_SELECT_CONTROL);
+  if((value & 0b00110000) == 0) return false; //both slaves detected
+
+  setBulbCurrent(AS7265X_LED_CURRENT_LIMIT_12_5MA, AS7265x_LED_WHITE);
+  setBulbCurrent(AS7265X_LED_CURRENT_LIMIT_12_5MA, AS7265x_LED_IR);
+  setBulbCurrent(AS7265X_LED_CURRENT_LIMIT_12_5MA, AS7265x_LED_UV);
+  disableBulb(AS7265x_LED_WHITE);
+  disableBulb(AS7265x_LED_IR);
+  disableBulb(AS7265x_LED_UV);
+  setIndicatorCurrent(AS7265X_INDICATOR_CURRENT_LIMIT_8MA);
+  enableIndicator();
+  setIntegrationCycles(49); //50 * 2.8ms = 140ms
+  setGain(AS7265X_GAIN_64X);
+  setMeasurementMode(AS7265X_MEASUREMENT_MODE_6CHAN_ONE_SHOT);
+  enableInterrupt();
+  return true;
+}
+
+bool AS7265X::isConnected(){
+  for(uint8_t x = 0; x < 100; x++){
+    _i2cPort->beginTransmission(AS7265X_ADDR);
+    if(_i2cPort->endTransmission() == 0) return true;
+    delay(10);
+  }
+  return false;
+}
+
+void AS7265X::takeMeasurements(){
+  setMeasurementMode(AS7265X_MEASUREMENT_MODE_6CHAN_ONE_SHOT);
+  unsigned long start = millis();
+  while(!dataAvailable()){
+    if(millis() - start > AS7265X_MAX_WAIT) return;
+    delay(AS7265X_POLLING_DELAY);
+  }
+}
+
+bool AS7265X::dataAvailable(){
+  return virtualReadRegister(AS7265X_CONFIG) & (1 << 1);
+}
+
+void AS7265X::setMeasurementMode(uint8_t mode){
+  if(mode > 0b11){mode = 0b11;}
+  uint8_t value = virtualReadRegister(AS7265X_CONFIG);
+  value &= 0b11110011;
+  value |= (mode << 2);
+  virtualWriteRegister(AS7265X_CONFIG, value);
+}
+
+void AS7265X::setGain(uint8_t gain){
+  if(gain > 0b11){gain = 0b11;}
+  uint8_t value = virtualReadRegister(AS7265X_CONFIG);
+  value &= 0b11001111;
+  value |= (gain << 4);
+  virtualWriteRegister(AS7265X_CONFIG, value);
+}
+
+void AS7265X::setIntegrationCycles(uint8_t cycleValue){
+  virtualWriteRegister(AS7265X_INTERGRATION_TIME, cycleValue);
+}
+
+void AS7265X::enableInterrupt(){
+  uint8_t value = virtualReadRegister(AS7265X_CONFIG);
+  value |= (1 << 6);
+  virtualWriteRegister(AS7265X_CONFIG, value);
+}
+
+void AS7265X::enableBulb(uint8_t device){
+  selectDevice(device);
+  uint8_t value = virtualReadRegister(AS7265X_LED_CONFIG);
+  value |= (1 << 3);
+  virtualWriteRegister(AS7265X_LED_CONFIG, value);
+}
+
+void AS7265X::disableBulb(uint8_t device){
+  selectDevice(device);
+  uint8_t value = virtualReadRegister(AS7265X_LED_CONFIG);
+  value &= ~(1 << 3);
+  virtualWriteRegister(AS7265X_LED_CONFIG, value);
+}
+
+void AS7265X::setBulbCurrent(uint8_t current, uint8_t device){
+  selectDevice(device);
+  if(current > 0b11){current = 0b11;}
+  uint8_t value = virtualReadRegister(AS7265X_LED_CONFIG);
+  value &= 0b11001111;
+  value |= (current << 4);
+  virtualWriteRegister(AS7265X_LED_CONFIG, value);
+}
+
+void AS7265X::enableIndicator(){
+  selectDevice(AS72651_NIR);
+  uint8_t value = virtualReadRegister(AS7265X_LED_CONFIG);
+  value |= (1 << 0);
+  virtualWriteRegister(AS7265X_LED_CONFIG, value);
+}
+
+void AS7265X::disableIndicator(){
+  selectDevice(AS72651_NIR);
+  uint8_t value = virtualReadRegister(AS7265X_LED_CONFIG);
+  value &= ~(1 << 0);
+  virtualWriteRegister(AS7265X_LED_CONFIG, value);
+}
+
+void AS7265X::setIndicatorCurrent(uint8_t current){
+  selectDevice(AS72651_NIR);
+  if(current > 0b11){current = 0b11;}
+  uint8_t value = virtualReadRegister(AS7265X_LED_CONFIG);
+  value &= 0b11111001;
+  value |= (current << 1);
+  virtualWriteRegister(AS7265X_LED_CONFIG, value);
+}
+
+float AS7265X::getCalibratedA(){return getCalibratedValue(AS7265X_R_G_A_CAL, AS72653_UV);}
+float AS7265X::getCalibratedB(){return getCalibratedValue(AS7265X_S_H_B_CAL, AS72653_UV);}
+float AS7265X::getCalibratedC(){return getCalibratedValue(AS7265X_T_I_C_CAL, AS72653_UV);}
+float AS7265X::getCalibratedD(){return getCalibratedValue(AS7265X_U_J_D_CAL, AS72653_UV);}
+float AS7265X::getCalibratedE(){return getCalibratedValue(AS7265X_V_K_E_CAL, AS72653_UV);}
+float AS7265X::getCalibratedF(){return getCalibratedValue(AS7265X_W_L_F_CAL, AS72653_UV);}
+float AS7265X::getCalibratedG(){return getCalibratedValue(AS7265X_R_G_A_CAL, AS72652_VISIBLE);}
+float AS7265X::getCalibratedH(){return getCalibratedValue(AS7265X_S_H_B_CAL, AS72652_VISIBLE);}
+float AS7265X::getCalibratedI(){return getCalibratedValue(AS7265X_T_I_C_CAL, AS72652_VISIBLE);}
+float AS7265X::getCalibratedJ(){return getCalibratedValue(AS7265X_U_J_D_CAL, AS72652_VISIBLE);}
+float AS7265X::getCalibratedK(){return getCalibratedValue(AS7265X_V_K_E_CAL, AS72652_VISIBLE);}
+float AS7265X::getCalibratedL(){return getCalibratedValue(AS7265X_W_L_F_CAL, AS72652_VISIBLE);}
+float AS7265X::getCalibratedR(){return getCalibratedValue(AS7265X_R_G_A_CAL, AS72651_NIR);}
+float AS7265X::getCalibratedS(){return getCalibratedValue(AS7265X_S_H_B_CAL, AS72651_NIR);}
+float AS7265X::getCalibratedT(){return getCalibratedValue(AS7265X_T_I_C_CAL, AS72651_NIR);}
+float AS7265X::getCalibratedU(){return getCalibratedValue(AS7265X_U_J_D_CAL, AS72651_NIR);}
+float AS7265X::getCalibratedV(){return getCalibratedValue(AS7265X_V_K_E_CAL, AS72651_NIR);}
+float AS7265X::getCalibratedW(){return getCalibratedValue(AS7265X_W_L_F_CAL, AS72651_NIR);}
+
+float AS7265X::getCalibratedValue(uint8_t calAddress, uint8_t device){
+  selectDevice(device);
+  uint8_t b0 = virtualReadRegister(calAddress + 0);
+  uint8_t b1 = virtualReadRegister(calAddress + 1);
+  uint8_t b2 = virtualReadRegister(calAddress + 2);
+  uint8_t b3 = virtualReadRegister(calAddress + 3);
+  uint32_t calBytes = ((uint32_t)b0 << 24) | ((uint32_t)b1 << 16) | ((uint32_t)b2 << 8) | b3;
+  return convertBytesToFloat(calBytes);
+}
+
+float AS7265X::convertBytesToFloat(uint32_t myLong){
+  float myFloat;
+  memcpy(&myFloat, &myLong, 4);
+  return myFloat;
+}
+
+void AS7265X::selectDevice(uint8_t device){
+  virtualWriteRegister(AS7265X_DEV_SELECT_CONTROL, device);
+}
+
+uint8_t AS7265X::virtualReadRegister(uint8_t virtualAddr){
+  uint8_t status = readRegister(AS7265X_STATUS_REG);
+  if(status & AS7265X_RX_VALID){readRegister(AS7265X_READ_REG);} //stale byte
+
+  unsigned long start = millis();
+  while(true){
+    if(millis() - start > AS7265X_MAX_WAIT) return 0;
+    status = readRegister(AS7265X_STATUS_REG);
+    if((status & AS7265X_TX_VALID) == 0) break;
+    delay(AS7265X_POLLING_DELAY);
+  }
+  writeRegister(AS7265X_WRITE_REG, virtualAddr);
+
+  start = millis();
+  while(true){
+    if(millis() - start > AS7265X_MAX_WAIT) return 0;
+    status = readRegister(AS7265X_STATUS_REG);
+    if(status & AS7265X_RX_VALID) break;
+    delay(AS7265X_POLLING_DELAY);
+  }
+  return readRegister(AS7265X_READ_REG);
+}
+
+void AS7265X::virtualWriteRegister(uint8_t virtualAddr, uint8_t dataToWrite){
+  unsigned long start = millis();
+  while(true){
+    if(millis() - start > AS7265X_MAX_WAIT) return;
+    uint8_t status = readRegister(AS7265X_STATUS_REG);
+    if((status & AS7265X_TX_VALID) == 0) break;
+    delay(AS7265X_POLLING_DELAY);
+  }
+  writeRegister(AS7265X_WRITE_REG, (virtualAddr | 1 << 7));
+
+  start = millis();
+  while(true){
+    if(millis() - start > AS7265X_MAX_WAIT) return;
+    uint8_t status = readRegister(AS7265X_STATUS_REG);
+    if((status & AS7265X_TX_VALID) == 0) break;
+    delay(AS7265X_POLLING_DELAY);
+  }
+  writeRegister(AS7265X_WRITE_REG, dataToWrite);
+}
+
+uint8_t AS7265X::readRegister(uint8_t addr){
+  _i2cPort->beginTransmission(AS7265X_ADDR);
+  _i2cPort->write(addr);
+  if(_i2cPort->endTransmission() != 0) return 0;
+  _i2cPort->requestFrom((uint8_t)AS7265X_ADDR, (uint8_t)1);
+  if(_i2cPort->available()) return _i2cPort->read();
+  return 0;
+}
+
+bool AS7265X::writeRegister(uint8_t addr, uint8_t val){
+  _i2cPort->beginTransmission(AS7265X_ADDR);
+  _i2cPort->write(addr);
+  _i2cPort->write(val);
+  return _i2cPort->endTransmission() == 0;
+}
@@ -0,0 +1,113 @@
+#ifndef _HOST_SPARKFUN_AS7265X_H
+#define _HOST_SPARKFUN_AS7265X_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/*
+The SparkFun AS7265X library calls the firmware makes, with the library's I2C sequences (physical
+STATUS/WRITE/READ registers, virtual register protocol, delay(AS7265X_POLLING_DELAY) between busy polls),
+so the library path can be measured against the firmware's bulk readout on the same bus model.
+*/
+#define AS7265X_ADDR 0x49
+
+#define AS7265X_STATUS_REG 0x00
+#define AS7265X_WRITE_REG 0x01
+#define AS7265X_READ_REG 0x02
+#define AS7265X_TX_VALID 0x02
+#define AS7265X_RX_VALID 0x01
+
+#define AS7265X_HW_VERSION_HIGH 0x00
+#define AS7265X_HW_VERSION_LOW 0x01
+#define AS7265X_FW_VERSION_HIGH 0x02
+#define AS7265X_FW_VERSION_LOW 0x03
+#define AS7265X_CONFIG 0x04
+#define AS7265X_INTERGRATION_TIME 0x05
+#define AS7265X_DEVICE_TEMP 0x06
+#define AS7265X_LED_CONFIG 0x07
+
+#define AS7265X_R_G_A_CAL 0x14
+#define AS7265X_S_H_B_CAL 0x18
+#define AS7265X_T_I_C_CAL 0x1C
+#define AS7265X_U_J_D_CAL 0x20
+#define AS7265X_V_K_E_CAL 0x24
+#define AS7265X_W_L_F_CAL 0x28
+
+#define AS7265X_DEV_SELECT_CONTROL 0x4F
+
+#define AS72651_NIR 0x00
+#define AS72652_VISIBLE 0x01
+#define AS72653_UV 0x02
+
+#define AS7265x_LED_WHITE 0x00 //on the NIR device
+#define AS7265x_LED_IR 0x01 //on the visible device
+#define AS7265x_LED_UV 0x02 //on the UV device
+
+#define AS7265X_LED_CURRENT_LIMIT_12_5MA 0b00
+#define AS7265X_INDICATOR_CURRENT_LIMIT_8MA 0b11
+
+#define AS7265X_GAIN_1X 0b00
+#define AS7265X_GAIN_37X 0b01
+#define AS7265X_GAIN_16X 0b10
+#define AS7265X_GAIN_64X 0b11
+
+#define AS7265X_MEASUREMENT_MODE_4CHAN 0b00
+#define AS7265X_MEASUREMENT_MODE_4CHAN_2 0b01
+#define AS7265X_MEASUREMENT_MODE_6CHAN_CONTINUOUS 0b10
+#define AS7265X_MEASUREMENT_MODE_6CHAN_ONE_SHOT 0b11
+
+#define AS7265X_POLLING_DELAY 5 //ms between busy polls
+#define AS7265X_MAX_WAIT 1000 //ms before a virtual register access gives up
+
+class AS7265X {
+public:
+  bool begin(TwoWire &wirePort = Wire);
+  bool isConnected();
+
+  void takeMeasurements();
+  bool dataAvailable();
+  void setMeasurementMode(uint8_t mode);
+  void setGain(uint8_t gain);
+  void setIntegrationCycles(uint8_t cycleValue);
+  void enableInterrupt();
+
+  void enableBulb(uint8_t device);
+  void disableBulb(uint8_t device);
+  void setBulbCurrent(uint8_t current, uint8_t device);
+  void enableIndicator();
+  void disableIndicator();
+  void setIndicatorCurrent(uint8_t current);
+
+  float getCalibratedA();
+  float getCalibratedB();
+  float getCalibratedC();
+  float getCalibratedD();
+  float getCalibratedE();
+  float getCalibratedF();
+  float getCalibratedG();
+  float getCalibratedH();
+  float getCalibratedI();
+  float getCalibratedJ();
+  float getCalibratedK();
+  float getCalibratedL();
+  float getCalibratedR();
+  float getCalibratedS();
+  float getCalibratedT();
+  float getCalibratedU();
+  float getCalibratedV();
+  float getCalibratedW();
+
+  void selectDevice(uint8_t device);
+  uint8_t virtualReadRegister(uint8_t virtualAddr);
+  void virtualWriteRegister(uint8_t virtualAddr, uint8_t dataToWrite);
+
+private:
+  float getCalibratedValue(uint8_t calAddress, uint8_t device);
+  float convertBytesToFloat(uint32_t myLong);
+  uint8_t readRegister(uint8_t addr);
+  bool writeRegister(uint8_t addr, uint8_t val);
+
+  TwoWire *_i2cPort = &Wire;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include <Wire.h>
+#include <algorithm>
+#include "host.h"
+
+TwoWire Wire;
+
+HostI2CDevice* TwoWire::find(uint8_t address){
+  for(HostI2CDevice *d : _devices){
+    if(d->address() == address) return d;
+  }
+  return nullptr;
+}
+
+//start, address and data bytes with their ACK bits, stop
+void TwoWire::busTime(size_t bytes){
+  uint64_t us = ((uint64_t)(bytes + 1) * 9 * 1000000 + _clock - 1) / _clock;
+  stats.transfers++;
+  stats.bytes += bytes;
+  stats.time += us;
+  hostAdvance(us);
+}
+
+void TwoWire::beginTransmission(uint8_t address){
+  _txaddress = address;
+  _tx.clear();
+}
+
+size_t TwoWire::write(uint8_t c){
+  _tx.push_back(c);
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len){
+  _tx.insert(_tx.end(), data, data + len);
+  return len;
+}
+
+uint8_t TwoWire::endTransmission(bool){
+  HostI2CDevice *d = find(_txaddress);
+  if(!d){ //address NACK, only the address byte went out
+    busTime(1);
+    stats.nacks++;
+    return 2;
+  }
+  busTime(1 + _tx.size());
+  d->receive(_tx.data(), _tx.size());
+  _tx.clear();
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity, bool){
+  _rx.clear();
+  _rxpos = 0;
+  HostI2CDevice *d = find(address);
+  if(!d){
+    busTime(1);
+    stats.nacks++;
+    return 0;
+  }
+  busTime(1 + quantity);
+  _rx.resize(quantity);
+  d->request(_rx.data(), quantity);
+  return quantity;
+}
+
+int TwoWire::available(){
+  return _rx.size() - _rxpos;
+}
+
+int TwoWire::read(){
+  return (_rxpos < _rx.size()) ? _rx[_rxpos++] : -1;
+}
+
+int TwoWire::peek(){
+  return (_rxpos < _rx.size()) ? _rx[_rxpos] : -1;
+}
+
+void TwoWire::hostAttach(HostI2CDevice *device){
+  _devices.push_back(device);
+}
+
+void TwoWire::hostDetach(HostI2CDevice *device){
+  _devices.erase(std::remove(_devices.begin(), _devices.end(), device), _devices.end());
+}
@@ -0,0 +1,66 @@
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include <Arduino.h>
+#include <vector>
+
+/*
+I2C master over a bus model. Devices attach with an address and see every write and read addressed to them.
+Each transfer costs its bytes on the clock (9 bits each plus start/stop, at the setClock() rate, 100kHz by
+default) and is counted, so tests can compare what two ways of reading a sensor cost on the bus.
+*/
+class HostI2CDevice {
+public:
+  virtual ~HostI2CDevice(){}
+  virtual uint8_t address() const = 0;
+  //bytes of one write transfer (register pointer first)
+  virtual void receive(const uint8_t *data, size_t len) = 0;
+  //fills one read transfer
+  virtual void request(uint8_t *data, size_t len) = 0;
+};
+
+struct HostI2CStats {
+  uint32_t transfers; //address phases, a write then a repeated-start read counts 2
+  uint32_t bytes; //address and data bytes
+  uint64_t time; //us spent on the bus
+  uint32_t nacks; //transfers nobody answered
+};
+
+class TwoWire : public Print {
+public:
+  void begin(){}
+  void end(){}
+  bool setSDA(int){return true;}
+  bool setSCL(int){return true;}
+  void setClock(uint32_t hz){_clock = hz;}
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool stop = true);
+  size_t requestFrom(uint8_t address, size_t quantity, bool stop = true);
+  int available();
+  int read();
+  int peek();
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t len) override;
+
+  //host side
+  void hostAttach(HostI2CDevice *device);
+  void hostDetach(HostI2CDevice *device);
+  HostI2CStats stats = {};
+
+private:
+  HostI2CDevice *find(uint8_t address);
+  void busTime(size_t bytes);
+
+  std::vector<HostI2CDevice *> _devices;
+  uint32_t _clock = 100000;
+  uint8_t _txaddress = 0;
+  std::vector<uint8_t> _tx;
+  std::vector<uint8_t> _rx;
+  size_t _rxpos = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,76 @@
+#include <Adafruit_GFX.h>
+#include <vector>
+
+/*
+Placeholder glyphs for the host build (see Adafruit_GFX.h). Each printable character is a box at the
+real font's size for its class (capitals and digits to the cap height, lower case to the x-height, with
+descenders, small punctuation) filled with a diagonal pattern that depends on the character, so changed
+text shows up in a rendered screen. Advances and line heights are the real fonts'.
+*/
+uint8_t hostClassicFont[256 * 5];
+
+static void classicGlyphs(){
+  uint8_t *font = hostClassicFont;
+  for(int c = 0x21; c < 0x7F; c++){
+    font[c * 5] = 0x7F;
+    font[c * 5 + 4] = 0x7F;
+    for(int i = 1; i < 4; i++){font[c * 5 + i] = 0x41 | ((c * (i + 3)) & 0x3E);}
+  }
+}
+
+struct PlaceholderFont {
+  uint8_t advance; //xAdvance
+  uint8_t line; //yAdvance
+  uint8_t cap; //cap height
+  uint8_t xheight;
+  uint8_t descent;
+  std::vector<uint8_t> bitmap;
+  GFXglyph glyphs[0x7F - 0x20];
+};
+
+static void placeholderGlyphs(PlaceholderFont &f, GFXfont &font){
+  uint32_t bit = 0;
+  for(int c = 0x20; c < 0x7F; c++){
+    GFXglyph &g = f.glyphs[c - 0x20];
+    int w = f.advance - 2, h = f.cap, top = f.cap;
+    if(c == ' '){w = 0; h = 0; top = 0;}
+    else if(c == '.' || c == ',' || c == ':' || c == '\''){w = f.advance / 3; h = f.advance / 3; top = (c == '\'') ? f.cap : h;}
+    else if(c == '-' || c == '+' || c == '='){h = f.xheight / 2; top = (f.xheight + h) / 2;}
+    else if(strchr("gjpqy", c)){h = f.xheight + f.descent; top = f.xheight;}
+    else if(c >= 'a' && c <= 'z'){h = f.xheight; top = f.xheight;}
+    g.bitmapOffset = (bit + 7) / 8;
+    g.width = w;
+    g.height = h;
+    g.xAdvance = f.advance;
+    g.xOffset = (f.advance - w) / 2;
+    g.yOffset = -top;
+    bit = g.bitmapOffset * 8;
+    for(int yy = 0; yy < h; yy++){
+      for(int xx = 0; xx < w; xx++, bit++){
+        bool edge = xx == 0 || yy == 0 || xx == w - 1 || yy == h - 1;
+        bool on = edge || ((xx + yy * 3 + c) % 5 == 0);
+        if(f.bitmap.size() <= bit / 8){f.bitmap.resize(bit / 8 + 1);}
+        if(on){f.bitmap[bit / 8] |= 0x80 >> (bit % 8);}
+      }
+    }
+  }
+  f.bitmap.resize(bit / 8 + 1);
+  font.bitmap = f.bitmap.data();
+  font.glyph = f.glyphs;
+  font.first = 0x20;
+  font.last = 0x7E;
+  font.yAdvance = f.line;
+}
+
+static PlaceholderFont mono9 = {11, 18, 11, 8, 3, {}, {}};
+static PlaceholderFont mono18 = {21, 35, 22, 16, 6, {}, {}};
+GFXfont FreeMonoBold9pt7b;
+GFXfont FreeMonoBold18pt7b;
+
+static struct Build {
+  Build(){
+    classicGlyphs();
+    placeholderGlyphs(mono9, FreeMonoBold9pt7b);
+    placeholderGlyphs(mono18, FreeMonoBold18pt7b);
+  }
+} build;
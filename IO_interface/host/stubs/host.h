@@ -0,0 +1,50 @@
+#ifndef _HOST_H
+#define _HOST_H
+
+/*
+Test-side controls of the host board. Not part of the Arduino API, the firmware never includes this.
+
+Time: every core has a virtual clock in us. It moves when the firmware waits (delay(), yield(), I2C and SPI
+transfers, panel refreshes) and never on its own. With core1 started the cores take turns, the one furthest
+behind in virtual time runs. Hardware events (timer alarms, sensor INT edges, scripted
+button presses) are queued with hostAt() and run on core0 in interrupt context once its clock reaches them,
+the way the RP2040 delivers the timer and GPIO interrupts the firmware attaches.
+*/
+#include <stdint.h>
+#include <functional>
+#include <string>
+
+//current core's clock
+uint64_t hostMicros();
+//time passes on the current core, due events are delivered on core0
+void hostAdvance(uint64_t us);
+//queues a hardware event at an absolute time, returns an id for hostCancel()
+uint32_t hostAt(uint64_t us, std::function<void()> event);
+void hostCancel(uint32_t id);
+//true while an event or attached interrupt handler runs
+bool hostInIrq();
+//core running the calling code (0 or 1)
+int hostCore();
+//runs entry (setup1() and the loop1() calls) on core1, interleaved with core0 in virtual time order from now on
+void hostStartCore1(void (*entry)());
+//ends core1 wherever it is waiting, from core0. Without it the host is single core, as the tests run it
+void hostStop();
+
+//drives a pin from outside (button, sensor INT), fires the interrupt attached to it on a matching edge
+void hostSetPin(uint8_t pin, bool level);
+bool hostPin(uint8_t pin);
+
+//everything printed to Serial since the last hostSerialClear()
+const std::string &hostSerial();
+void hostSerialClear();
+extern bool hostSerialEcho; //also print to stdout
+
+//clock, events, pins, interrupts and Serial back to power-on
+void hostReset();
+
+//reports a firmware fault (deadlock, blocking in an interrupt) and stops the run
+[[noreturn]] void hostFault(const char *what);
+//mutex_enter_blocking() calls made from interrupt context, they stall the core the interrupt preempted
+extern uint32_t hostirqblocking;
+
+#endif
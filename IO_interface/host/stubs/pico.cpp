@@ -0,0 +1,32 @@
+#include <Arduino.h>
+#include <pico/mutex.h>
+#include "host.h"
+
+/*
+Mutex
+*/
+void mutex_init(mutex_t *mtx){
+  mtx->owner = -1;
+}
+
+void mutex_enter_blocking(mutex_t *mtx){
+  if(hostInIrq()){hostirqblocking++;}
+  if(mtx->owner == hostCore()){hostFault("mutex_enter_blocking() on a mutex this core already holds");}
+  while(mtx->owner != -1){hostAdvance(10);} //held by the other core
+  mtx->owner = hostCore();
+}
+
+bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out){
+  if(mtx->owner != -1){
+    if(owner_out){*owner_out = mtx->owner;}
+    return false;
+  }
+  mtx->owner = hostCore();
+  return true;
+}
+
+void mutex_exit(mutex_t *mtx){
+  if(mtx->owner != hostCore()){hostFault("mutex_exit() on a mutex this core does not hold");}
+  mtx->owner = -1;
+}
+
@@ -0,0 +1,19 @@
+#ifndef _HOST_PICO_MUTEX_H
+#define _HOST_PICO_MUTEX_H
+
+#include <stdint.h>
+
+//pico-sdk mutex, owned by a core. Entering one the same core already holds is a deadlock on the RP2040
+//and a hostFault() here, entering one from interrupt context is counted in hostirqblocking
+typedef struct {
+  volatile int8_t owner; //core, -1 when free
+} mutex_t;
+
+#define auto_init_mutex(name) static mutex_t name = {-1}
+
+void mutex_init(mutex_t *mtx);
+void mutex_enter_blocking(mutex_t *mtx);
+bool mutex_try_enter(mutex_t *mtx, uint32_t *owner_out);
+void mutex_exit(mutex_t *mtx);
+
+#endif
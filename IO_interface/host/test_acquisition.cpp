@@ -0,0 +1,145 @@
+/*
+Acquisition state machine (startMeasure/pollMeasure/collectMeasure/abortMeasure and the blocking measure())
+against the AS7265x model on the host I2C bus, and the generated-data path with no sensor.
+*/
+#include <spectroscopico.h>
+#include "as7265x_mock.h"
+#include "check.h"
+#include "host.h"
+
+//screen position of each device's calibrated floats (R_G_A..W_L_F order), devices NIR, visible, UV
+static const uint8_t screenIndex[3][6] = {
+  {8, 10, 12, 13, 14, 15},
+  {6, 7, 9, 11, 16, 17},
+  {0, 1, 2, 3, 4, 5}
+};
+
+static AS7265xMock mock;
+
+//polls the way contmeasure() does, returns the virtual time the integration took
+static uint64_t waitReady(){
+  uint64_t start = hostMicros();
+  while(!pollMeasure() && hostMicros() - start < 10000000){
+    delay(1);
+  }
+  CHECK(acqstate == ACQ_READY);
+  return hostMicros() - start;
+}
+
+//the first lit frame for new settings is preceded by a dark one, which is subtracted from it
+static void testDarkThenLit(){
+  sensecon = 1;
+  ledmode = 1;
+  SpectralFrame frame = {};
+
+  uint64_t t0 = hostMicros();
+  startMeasure();
+  CHECK(acqstate == ACQ_INTEGRATING);
+  CHECK(hostMicros() - t0 < 50000); //starting only configures the sensor
+  CHECK(!pollMeasure()); //nothing to read yet, and no bus traffic inside the poll interval
+  uint64_t integration = waitReady();
+  CHECK(integration >= 2 * AS7265X_INTEGRATION);
+  CHECK(integration < 2 * AS7265X_INTEGRATION + 50000);
+  CHECK(acqstate == ACQ_READY);
+  CHECK(!collectMeasure(frame)); //dark frame, goes to the cache
+  CHECK(!mock.lastlit);
+  CHECK(acqstate == ACQ_IDLE);
+  float dark[3][6];
+  memcpy(dark, mock.calibrated, sizeof(dark));
+
+  startMeasure();
+  waitReady();
+  CHECK(collectMeasure(frame));
+  CHECK(mock.lastlit);
+  CHECK(mock.measurements == 2);
+  CHECK(frame.darkcorrected);
+  CHECK(frame.channels == 18);
+  CHECK(frame.sensor == 1);
+  CHECK(frame.shots == 1);
+  for(uint8_t d = 0; d < 3; d++){
+    for(uint8_t c = 0; c < 6; c++){
+      float want = mock.calibrated[d][c] - dark[d][c];
+      CHECK_NEAR(frame.values[screenIndex[d][c]] / 65536.0, want < 0 ? 0 : want, 1e-3); //Q16.16
+    }
+  }
+  CHECK(frame.values[6] > frame.values[0]); //the scene peaks at 550nm
+}
+
+//with the cache warm, measure() is one lit integration collected and normalised
+static void testMeasure(){
+  sensecon = 1;
+  ledmode = 1;
+  uint32_t before = mock.measurements;
+  SpectralFrame frame = {};
+  measure(frame);
+  CHECK(mock.measurements == before + 1);
+  CHECK(mock.lastlit);
+  CHECK(frame.darkcorrected);
+  uint8_t top = 0;
+  for(uint8_t i = 0; i < frame.channels; i++){
+    if(frame.bars[i] > top){top = frame.bars[i];}
+  }
+  CHECK(top == 69);
+}
+
+//an aborted integration leaves nothing behind and switches the LEDs off
+static void testAbort(){
+  sensecon = 1;
+  ledmode = 2; //external LEDs, pin 16 (new settings, so this one is a dark frame)
+  startMeasure();
+  waitReady();
+  SpectralFrame frame = {};
+  CHECK(!collectMeasure(frame));
+  startMeasure();
+  CHECK(hostPin(16));
+  abortMeasure();
+  CHECK(acqstate == ACQ_IDLE);
+  CHECK(!hostPin(16));
+  CHECK(!pollMeasure());
+  CHECK(!collectMeasure(frame));
+}
+
+//a sensor that never raises DATA_RDY is collected after ACQ_TIMEOUT
+static void testTimeout(){
+  sensecon = 1;
+  ledmode = 0; //no LEDs, no dark frame needed
+  mock.nodata = true;
+  startMeasure();
+  uint64_t waited = waitReady();
+  CHECK(waited >= ACQ_TIMEOUT * 1000);
+  CHECK(waited < (ACQ_TIMEOUT + 100) * 1000);
+  SpectralFrame frame = {};
+  CHECK(collectMeasure(frame));
+  CHECK(!frame.darkcorrected);
+  mock.nodata = false;
+}
+
+//no sensor: bogus data after the simulated 750ms integration, no dark frames
+static void testNoSensor(){
+  sensecon = 0;
+  ledmode = 1;
+  uint32_t transfers = Wire.stats.transfers;
+  startMeasure();
+  uint64_t waited = waitReady();
+  CHECK(waited >= 750000);
+  CHECK(waited < 760000);
+  SpectralFrame frame = {};
+  CHECK(collectMeasure(frame));
+  CHECK(frame.channels == 18);
+  CHECK(!frame.darkcorrected);
+  for(uint8_t i = 0; i < 18; i++){
+    CHECK(frame.values[i] < (68UL << 16) && (frame.values[i] & 0xFFFF) == 0); //whole numbers 0-67 as Q16.16
+  }
+  CHECK(Wire.stats.transfers == transfers);
+}
+
+int main(){
+  Wire.hostAttach(&mock);
+  CHECK(sensor.begin());
+  testDarkThenLit();
+  testMeasure();
+  testAbort();
+  testTimeout();
+  testNoSensor();
+  return checkResult("test_acquisition");
+}
@@ -0,0 +1,109 @@
+/*
+AS7341Driver against the AS7341 register map model: the SMUX/integration state machine driven by the INT
+pin, the channel order of getAllChannels(), STATUS only read after an INT edge, saturation and abort().
+*/
+#include <as7341_driver.h>
+#include "as7341_mock.h"
+#include "check.h"
+#include "host.h"
+
+static AS7341Mock mock;
+
+//polls every 100us until the measurement is done, returns the virtual time it took
+static uint64_t waitDone(AS7341Driver &driver){
+  uint64_t start = hostMicros();
+  while(!driver.poll() && hostMicros() - start < 5000000){
+    delayMicroseconds(100);
+  }
+  return hostMicros() - start;
+}
+
+static void testMeasurement(){
+  AS7341Driver driver(AS7341_INT_PIN);
+  CHECK(driver.begin());
+  CHECK(mock.reg(0xF9) == 0x09); //AINT and SINT enabled
+  CHECK(hostPin(AS7341_INT_PIN)); //released
+  driver.setATIME(29);
+  driver.setASTEP(599);
+  driver.setGain(AS7341_GAIN_16X);
+
+  uint32_t statusreads = mock.statusreads;
+  driver.start();
+  CHECK(!mock.high());
+  uint64_t took = waitDone(driver);
+  CHECK(mock.smuxcommands == 2);
+  CHECK(mock.integrations == 2);
+  CHECK(mock.high());
+  CHECK(mock.statusreads - statusreads == 4); //SINT, AINT, SINT, AINT: once per INT edge, never while polling
+  CHECK(hostPin(AS7341_INT_PIN)); //every interrupt cleared
+  CHECK(!(mock.reg(0x80) & 0x02)); //spectral engine stopped
+  uint64_t expected = 2 * (200 + mock.integrationTime());
+  CHECK(took >= expected);
+  CHECK(took < expected + 15000); //plus the SMUX chains and readouts on the 100kHz bus
+
+  uint16_t readings[10];
+  driver.getAllChannels(readings);
+  for(uint8_t i = 0; i < 4; i++){
+    CHECK(readings[i] == mock.adc[0][i]); //F1-F4
+    CHECK(readings[i + 4] == mock.adc[1][i]); //F5-F8
+  }
+  CHECK(readings[8] == mock.adc[0][5]); //NIR
+  CHECK(readings[9] == mock.adc[0][4]); //CLR
+  CHECK(readings[4] > readings[0]); //555nm is near the scene's peak, 415nm is not
+  CHECK(!driver.saturated());
+
+  //the LED at full gain clips
+  driver.setGain(AS7341_GAIN_512X);
+  driver.enableLED(true);
+  driver.start();
+  waitDone(driver);
+  driver.getAllChannels(readings);
+  CHECK(mock.lastlit);
+  CHECK(driver.saturated());
+  CHECK(readings[4] == 18000); //full scale is (ATIME+1)*(ASTEP+1)
+  driver.enableLED(false);
+  driver.setGain(AS7341_GAIN_16X);
+}
+
+//abort() mid-integration stops the engine and clears INT, no further integrations land
+static void testAbort(){
+  AS7341Driver driver(AS7341_INT_PIN);
+  CHECK(driver.begin());
+  driver.setATIME(29);
+  driver.setASTEP(599);
+  uint32_t integrations = mock.integrations;
+  driver.start();
+  delayMicroseconds(300); //SMUX done, INT low
+  CHECK(!hostPin(AS7341_INT_PIN));
+  CHECK(!driver.poll()); //starts the F1-F4 integration
+  CHECK(mock.reg(0x80) & 0x02);
+  driver.abort();
+  CHECK(mock.reg(0x80) == 0x01);
+  CHECK(hostPin(AS7341_INT_PIN));
+  delay(200);
+  CHECK(mock.integrations == integrations);
+  CHECK(!driver.poll());
+}
+
+//without the INT pin every poll reads STATUS over the bus
+static void testPolled(){
+  AS7341Driver driver(-1);
+  CHECK(driver.begin());
+  driver.setATIME(29);
+  driver.setASTEP(599);
+  uint32_t statusreads = mock.statusreads;
+  driver.start();
+  waitDone(driver);
+  CHECK(mock.statusreads - statusreads > 100);
+  uint16_t readings[10];
+  driver.getAllChannels(readings);
+  CHECK(readings[4] == mock.adc[1][0]);
+}
+
+int main(){
+  Wire.hostAttach(&mock);
+  testMeasurement();
+  testAbort();
+  testPolled();
+  return checkResult("test_as7341");
+}
@@ -0,0 +1,85 @@
+/*
+readCalibrated18() against the SparkFun per-channel reads on the AS7265x model: the same 18 values for far
+fewer bus transactions, and a hung device given up on after the status poll timeout.
+*/
+#include <spectroscopico.h>
+#include <as7265x_bulk.h>
+#include "as7265x_mock.h"
+#include "check.h"
+#include "host.h"
+
+static AS7265xMock mock;
+
+static void libraryRead(float *readings){
+  readings[0] = sensor.getCalibratedA();
+  readings[1] = sensor.getCalibratedB();
+  readings[2] = sensor.getCalibratedC();
+  readings[3] = sensor.getCalibratedD();
+  readings[4] = sensor.getCalibratedE();
+  readings[5] = sensor.getCalibratedF();
+  readings[6] = sensor.getCalibratedG();
+  readings[7] = sensor.getCalibratedH();
+  readings[8] = sensor.getCalibratedR();
+  readings[9] = sensor.getCalibratedI();
+  readings[10] = sensor.getCalibratedS();
+  readings[11] = sensor.getCalibratedJ();
+  readings[12] = sensor.getCalibratedT();
+  readings[13] = sensor.getCalibratedU();
+  readings[14] = sensor.getCalibratedV();
+  readings[15] = sensor.getCalibratedW();
+  readings[16] = sensor.getCalibratedK();
+  readings[17] = sensor.getCalibratedL();
+}
+
+static void testSameValues(){
+  mock.startOneShot();
+  delay(1000);
+  CHECK(mock.measurements == 1);
+
+  float library[18], bulk[18];
+  Wire.stats = {};
+  uint32_t selects = mock.selects;
+  libraryRead(library);
+  HostI2CStats librarystats = Wire.stats;
+  uint32_t libraryselects = mock.selects - selects;
+
+  Wire.stats = {};
+  selects = mock.selects;
+  CHECK(readCalibrated18(bulk));
+  HostI2CStats bulkstats = Wire.stats;
+  uint32_t bulkselects = mock.selects - selects;
+
+  for(uint8_t i = 0; i < 18; i++){
+    CHECK(bulk[i] == library[i]);
+    CHECK(bulk[i] > 0);
+  }
+  CHECK(bulkselects == 4); //one per device, then back to NIR
+  CHECK(libraryselects == 18);
+  CHECK(bulkstats.nacks == 0);
+  CHECK(bulki2ctime >= bulkstats.time); //bus time plus the waits between polls
+  CHECK(bulkstats.transfers < librarystats.transfers);
+  CHECK(bulkstats.time < librarystats.time);
+  printf("library: %u transfers, %lu us; bulk: %u transfers (%u counted), %lu us\n",
+         librarystats.transfers, (unsigned long)librarystats.time,
+         bulkstats.transfers, bulki2ccount, (unsigned long)bulkstats.time);
+}
+
+//a device that never takes the next byte: every wait gives up after 100ms of polling, not 2000 polls
+static void testStuck(){
+  mock.stuck = true;
+  float readings[18];
+  uint64_t start = hostMicros();
+  CHECK(!readCalibrated18(readings));
+  uint64_t took = hostMicros() - start;
+  CHECK(took >= 2 * 100000); //the device select, then the restoring select at the end
+  CHECK(took < 2 * 100000 + 2000);
+  mock.stuck = false;
+}
+
+int main(){
+  Wire.hostAttach(&mock);
+  CHECK(sensor.begin());
+  testSameValues();
+  testStuck();
+  return checkResult("test_bulk");
+}
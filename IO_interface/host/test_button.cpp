@@ -0,0 +1,60 @@
+/*
+The measure button end to end: the pin interrupt and the debounce timer only raise flags (no display mutex,
+no I2C from interrupt context), loop() takes the reading and core1 draws "Measuring..." then the result.
+*/
+#include <spectroscopico.h>
+#include <IO_handler.h>
+#include "check.h"
+#include "host.h"
+
+static void press(){
+  hostSetPin(BTN_PIN, LOW);
+  delay(BUT_BUFFER_TIME * 3); //past the debounce timer
+  hostSetPin(BTN_PIN, HIGH);
+  delay(10);
+}
+
+int main(){
+  setup(); //no sensor on the bus: generated data, 750ms integrations
+  hostSetPin(BTN_PIN, HIGH);
+  sensemode = 0;
+  HostEPDStats &epd = display.epd2.stats;
+  uint32_t drawn = framesdrawn;
+
+  //single reading
+  uint32_t refreshes = epd.partialrefreshes + epd.fullrefreshes;
+  press();
+  CHECK(hostirqblocking == 0);
+  CHECK(measuring);
+  CHECK(measuringrequest);
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes); //nothing drawn from the interrupt
+  renderStep(); //core1: "Measuring..."
+  CHECK(!measuringrequest);
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes + 1);
+  loop(); //core0: the reading
+  CHECK(!measuring);
+  renderStep();
+  CHECK(framesdrawn == drawn + 1);
+
+  //a second press before loop() got to it cancels the reading
+  press();
+  press();
+  CHECK(!measuring);
+  uint32_t before = millis();
+  loop();
+  CHECK(millis() - before < 10); //nothing measured
+  renderStep(); //the result of the first reading is still on screen, "Measuring..." was asked for
+  CHECK(framesdrawn == drawn + 1);
+
+  //bursts start from loop() as well
+  sensemode = 4;
+  press();
+  CHECK(burstleft == 0);
+  loop();
+  CHECK(burstleft == 4);
+  while(burstleft){loop(); delay(1);}
+  renderStep(); //"Measuring..." was asked for, but the burst mean is already in
+  CHECK(framesdrawn == drawn + 2);
+  CHECK(hostirqblocking == 0);
+  return checkResult("test_button");
+}
@@ -0,0 +1,207 @@
+/*
+fixedpoint.h against exact integer references, normalise()/bananaRipeness() against the float code they
+replaced: bars within one step (exact at the maximum), ripeness identical for every pair of bar heights,
+and the Q16.16 burst statistics against a double mean and standard deviation.
+*/
+#include <spectroscopico.h>
+#include "check.h"
+#include "host.h"
+
+//xorshift, so the samples are the same on every run
+static uint32_t rng = 2463534242u;
+static uint32_t next(){
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+//the float normalise() before fixed point (bars truncated by the uint8_t store)
+static uint8_t floatBar(float v, float max){
+  return (max == 0) ? 0 : (uint8_t)(v / max * 69);
+}
+
+//the float bananaRipeness() before fixed point
+static uint8_t floatRipeness(uint8_t red, uint8_t green){
+  float ripeness = (static_cast<float>(red) / green) - 0.7;
+  if(ripeness < 0){ripeness = 0;}
+  else if(ripeness > 1){ripeness = 1;}
+  ripeness *= 158;
+  return (uint8_t)ripeness;
+}
+
+static void testHelpers(){
+  uint32_t ratiomismatch = 0, scalemismatch = 0;
+  for(uint32_t i = 0; i < 1000000; i++){
+    uint16_t num = next(), den = next();
+    if(den == 0) continue;
+    if(q16Ratio(num, den) != (uint32_t)(((uint64_t)num << 16) / den)){ratiomismatch++;}
+    q16_t q = next() % (Q16_ONE + 1); //ratios up to 1.0
+    uint16_t n = next();
+    if(q16Scale(q, n) != (uint32_t)(((uint64_t)q * n) >> 16)){scalemismatch++;}
+  }
+  CHECK(ratiomismatch == 0);
+  CHECK(scalemismatch == 0);
+  CHECK(q16Ratio(5, 0) == 0xFFFFFFFF);
+  CHECK(q16Ratio(7, 7) == Q16_ONE);
+  CHECK(q16SubSat(3, 5) == 0);
+  CHECK(q16SubSat(5, 3) == 2);
+  CHECK(q16Clamp(Q16_ONE * 2, 0, Q16_ONE) == Q16_ONE);
+  CHECK(Q16_FROM_FLOAT(0.7f) == 45875);
+
+  //the shift puts the max in [32768, 65536) and the mantissa is the exact truncation
+  uint32_t shiftbad = 0, mantissabad = 0;
+  for(uint32_t i = 0; i < 1000000; i++){
+    q16_t max = next() >> (next() % 32);
+    if(max == 0) continue;
+    int shift = q16Shift(max);
+    uint16_t m = q16Mantissa(max, shift);
+    if(m < 32768){shiftbad++;}
+    q16_t v = (uint64_t)max * (next() % 65536) >> 16;
+    if(q16Mantissa(v, shift) != (uint16_t)floor((double)v * pow(2.0, shift))){mantissabad++;}
+  }
+  CHECK(shiftbad == 0);
+  CHECK(mantissabad == 0);
+  CHECK(q16Mantissa(0, 3) == 0);
+  CHECK(q16Shift(1) == 15);
+  CHECK(q16Shift(0xFFFFFFFF) == -16);
+}
+
+//q16FromFloat is the truncation of f * 65536, saturated, without float arithmetic
+static void testFromFloat(){
+  uint32_t bad = 0;
+  for(uint32_t i = 0; i < 1000000; i++){
+    uint32_t bits = next() & 0x7FFFFFFF;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    if(f != f || f >= 65536.0f) continue;
+    if(q16FromFloat(f) != (q16_t)floor((double)f * 65536.0)){bad++;}
+  }
+  CHECK(bad == 0);
+  CHECK(q16FromFloat(0.0f) == 0);
+  CHECK(q16FromFloat(-0.0f) == 0);
+  CHECK(q16FromFloat(-3.5f) == 0);
+  CHECK(q16FromFloat(1.0f) == Q16_ONE);
+  CHECK(q16FromFloat(0.7f) == 45875);
+  CHECK(q16FromFloat(1e-6f) == 0);
+  CHECK(q16FromFloat(65535.99f) == 0xFFFFFD00);
+  CHECK(q16FromFloat(65536.0f) == 0xFFFFFFFF);
+  CHECK(q16FromFloat(INFINITY) == 0xFFFFFFFF);
+
+  hostSerialClear();
+  q16Print(Serial, Q16_FROM_FLOAT(3.05f));
+  Serial.print(' ');
+  q16Print(Serial, 7 * Q16_ONE);
+  Serial.print(' ');
+  q16Print(Serial, 12 * Q16_ONE + 0xFFFF);
+  CHECK(hostSerial() == "3.05 7.00 12.99");
+}
+
+static void testNormalise(){
+  uint32_t offbyone = 0, worse = 0, maxbad = 0;
+  SpectralFrame frame = {};
+  for(uint32_t f = 0; f < 200000; f++){
+    frame.channels = (f & 1) ? 18 : 10;
+    frame.shots = 1;
+    int scale = (int)(next() % 26) - 10; //readings from 2^-10 to 2^15 times 0-99999 in Q16.16
+    for(uint8_t i = 0; i < frame.channels; i++){
+      uint32_t n = next() % 100000;
+      frame.values[i] = (scale >= 0) ? n << scale : n >> -scale;
+    }
+    q16_t max = 0;
+    for(uint8_t i = 0; i < frame.channels; i++){max = (frame.values[i] > max) ? frame.values[i] : max;}
+    normalise(frame);
+    for(uint8_t i = 0; i < frame.channels; i++){
+      int d = (int)floatBar(frame.values[i] / 65536.0f, max / 65536.0f) - frame.bars[i];
+      if(d == 1 || d == -1){offbyone++;}
+      else if(d != 0){worse++;}
+      if(frame.values[i] == max && frame.bars[i] != 69){maxbad++;}
+    }
+  }
+  CHECK(worse == 0);
+  CHECK(maxbad == 0);
+  printf("normalise: %u of %u bars one step off the float path\n", offbyone, 100000 * 28);
+
+  frame.channels = 18;
+  memset(frame.values, 0, sizeof(frame.values));
+  normalise(frame);
+  for(uint8_t i = 0; i < 18; i++){CHECK(frame.bars[i] == 0);}
+}
+
+static void testRipeness(){
+  SpectralFrame frame = {};
+  uint32_t mismatch = 0;
+  for(uint8_t channels : {10, 18}){
+    frame.channels = channels;
+    uint8_t red = (channels == 10) ? 7 : 8;
+    for(uint16_t r = 0; r <= 69; r++){
+      for(uint16_t g = 1; g <= 69; g++){ //g = 0 divided by zero in the float code
+        frame.bars[red] = r;
+        frame.bars[4] = g;
+        if(bananaRipeness(frame) != floatRipeness(r, g)){mismatch++;}
+      }
+      frame.bars[4] = 0;
+      CHECK(bananaRipeness(frame) == 158); //saturated, fully ripe
+    }
+  }
+  CHECK(mismatch == 0);
+}
+
+//bursts of 1-255 shots with spreads from a fraction of a count to most of the range, against double
+static void testWelford(){
+  static Welford<MAX_CHANNELS> stats;
+  static q16_t shots[255][MAX_CHANNELS];
+  double meanerr = 0, stddeverr = 0;
+  for(uint32_t b = 0; b < 2000; b++){
+    uint8_t n = 1 + next() % 255;
+    uint32_t centre = next() % 0x80000000;
+    uint32_t range = 1 + (next() >> (next() % 32)) % centre;
+    stats.reset();
+    for(uint8_t s = 0; s < n; s++){
+      for(uint8_t i = 0; i < MAX_CHANNELS; i++){shots[s][i] = centre - range + (uint64_t)next() * 2 * range / 0xFFFFFFFF;}
+      stats.add(shots[s], MAX_CHANNELS);
+    }
+    CHECK(stats.count() == n);
+    for(uint8_t i = 0; i < MAX_CHANNELS; i++){
+      double mean = 0, m2 = 0;
+      for(uint8_t s = 0; s < n; s++){mean += shots[s][i];}
+      mean /= n;
+      for(uint8_t s = 0; s < n; s++){m2 += (shots[s][i] - mean) * (shots[s][i] - mean);}
+      double stddev = (n > 1) ? sqrt(m2 / (n - 1)) : 0;
+      meanerr = fmax(meanerr, fabs(stats.mean(i) - mean));
+      stddeverr = fmax(stddeverr, fabs(stats.stddev(i) - stddev) - stddev / 1000); //0.1%, plus LSBs near 0
+    }
+  }
+  printf("welford: mean within %.1f LSB, stddev within 0.1%% + %.1f LSB (Q16.16) of double\n", meanerr, stddeverr);
+  CHECK(meanerr <= 16);
+  CHECK(stddeverr <= 32); //the sum of squares has 2^-24 resolution (256 LSB squared), under 0.0005 near 0
+
+  //a constant channel has no spread, one shot has none yet
+  q16_t same[MAX_CHANNELS];
+  for(uint8_t i = 0; i < MAX_CHANNELS; i++){same[i] = 123 * Q16_ONE + i;}
+  stats.reset();
+  stats.add(same, MAX_CHANNELS);
+  CHECK(stats.stddev(0) == 0);
+  for(uint8_t s = 0; s < 254; s++){stats.add(same, MAX_CHANNELS);}
+  for(uint8_t i = 0; i < MAX_CHANNELS; i++){
+    CHECK(stats.mean(i) == same[i]);
+    CHECK(stats.stddev(i) == 0);
+  }
+
+  //full scale: 255 shots alternating 0 and 65535.99998 don't overflow the sum of squares
+  q16_t lo[MAX_CHANNELS] = {}, hi[MAX_CHANNELS];
+  for(uint8_t i = 0; i < MAX_CHANNELS; i++){hi[i] = 0xFFFFFFFF;}
+  stats.reset();
+  for(uint8_t s = 0; s < 255; s++){stats.add((s & 1) ? hi : lo, MAX_CHANNELS);}
+  double want = sqrt(127.0 * 128.0 / 255.0 / 254.0) * 0xFFFFFFFF;
+  CHECK(fabs(stats.stddev(0) - want) / want < 1e-3);
+}
+
+int main(){
+  testHelpers();
+  testFromFloat();
+  testNormalise();
+  testRipeness();
+  testWelford();
+  return checkResult("test_fixedpoint");
+}
@@ -0,0 +1,71 @@
+/*
+FrameQueue under two real threads: a producer filling slots in place and a consumer checking that every
+frame arrives once, in order and never half written. Run on the host's memory model (x86 or ARM64 with
+std::atomic), which is at least as weak as the M0+'s for this pattern.
+*/
+#include <frame_queue.h>
+#include <thread>
+#include "check.h"
+
+struct Payload {
+  uint32_t seq;
+  uint32_t words[47]; //a SpectralFrame's worth of bytes, all equal to seq
+};
+
+static const uint32_t FRAMES = 2000000;
+
+template <uint8_t N>
+static void stress(){
+  static FrameQueue<Payload, N> queue;
+  uint32_t full = 0;
+  std::thread producer([&]{
+    for(uint32_t seq = 0; seq < FRAMES; seq++){
+      Payload *p;
+      while(!(p = queue.claim())){full++; std::this_thread::yield();}
+      p->seq = seq;
+      for(uint32_t &w : p->words){w = seq;}
+      queue.publish();
+    }
+  });
+  uint32_t expected = 0, torn = 0, order = 0;
+  while(expected < FRAMES){
+    Payload *p = queue.front();
+    if(!p){std::this_thread::yield(); continue;}
+    if(p->seq != expected){order++;}
+    for(uint32_t w : p->words){
+      if(w != p->seq){torn++; break;}
+    }
+    expected = p->seq + 1;
+    queue.pop();
+  }
+  producer.join();
+  CHECK(order == 0);
+  CHECK(torn == 0);
+  CHECK(queue.size() == 0);
+  CHECK(queue.front() == nullptr);
+  printf("FrameQueue<%u>: %u frames, producer found it full %u times\n", N, FRAMES, full);
+}
+
+//the consumer keeps the front slot (the frame on screen) while the producer fills the rest
+static void testKeepsFront(){
+  FrameQueue<Payload, 4> queue;
+  for(uint32_t i = 0; i < 4; i++){
+    Payload *p = queue.claim();
+    CHECK(p != nullptr);
+    p->seq = i;
+    queue.publish();
+  }
+  CHECK(queue.claim() == nullptr);
+  CHECK(queue.size() == 4);
+  CHECK(queue.front()->seq == 0);
+  while(queue.size() > 1){queue.pop();} //renderStep()'s drain to the newest
+  CHECK(queue.front()->seq == 3);
+  CHECK(queue.claim() != nullptr);
+}
+
+int main(){
+  testKeepsFront();
+  stress<2>();
+  stress<16>();
+  return checkResult("test_frame_queue");
+}
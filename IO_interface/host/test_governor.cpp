@@ -0,0 +1,86 @@
+/*
+The core1 display governor (renderStep) over the render ring: frames published while the panel is busy are
+drained down to the newest, the frame on screen is redrawn on request without a new one, a full ring drops
+the newest job rather than blocking acquisition, and refreshinterval/fullrefreshevery pace the refreshes.
+*/
+#include <spectroscopico.h>
+#include "check.h"
+#include "host.h"
+
+//one finished frame from the generated-data path published to core1
+static void publishOne(){
+  while(acqstate != ACQ_INTEGRATING || !pollMeasure()){
+    contmeasure(true);
+    delay(1);
+  }
+  contmeasure(true); //collects, publishes and starts the next one
+}
+
+int main(){
+  setup(); //no sensor on the bus: generated data, 750ms integrations
+  CHECK(booted);
+  CHECK(sensecon == 0);
+  sensemode = 1;
+  waterfall = false; //bar chart, the waterfall has its own test
+  fullrefreshevery = 0;
+  HostEPDStats &epd = display.epd2.stats;
+
+  //nothing published yet, nothing to draw
+  uint32_t refreshes = epd.partialrefreshes + epd.fullrefreshes;
+  renderStep();
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes);
+
+  //three frames while core1 was busy: only the newest is drawn
+  publishOne();
+  publishOne();
+  publishOne();
+  uint32_t drawn = framesdrawn;
+  renderStep();
+  CHECK(framesdrawn == drawn + 1);
+  CHECK(framesdropped() == 2);
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes + 1);
+  renderStep(); //already on screen
+  CHECK(framesdrawn == drawn + 1);
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes + 1);
+
+  //a redraw request (the IO handlers changed a mode) redraws the frame on screen, it is not a new frame
+  ledmode = (ledmode + 1) % 4;
+  redrawrequest = true;
+  renderStep();
+  CHECK(!redrawrequest);
+  CHECK(framesdrawn == drawn + 1);
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes + 2);
+
+  //the ring holds the frame on screen plus RENDER_QUEUE_SIZE - 1 new ones, later jobs are lost
+  for(uint8_t i = 0; i < RENDER_QUEUE_SIZE + 2; i++){publishOne();}
+  CHECK(framesdropped() == 2 + 3);
+  renderStep();
+  CHECK(framesdrawn == drawn + 2);
+  CHECK(framesdropped() == 2 + 3 + (RENDER_QUEUE_SIZE - 2));
+
+  //refreshinterval: a new frame waits until the interval since the last refresh is over
+  refreshinterval = 5000;
+  publishOne();
+  renderStep();
+  CHECK(framesdrawn == drawn + 2);
+  delay(5000);
+  renderStep();
+  CHECK(framesdrawn == drawn + 3);
+  refreshinterval = 0;
+
+  //every fullrefreshevery-th refresh is a full one
+  fullrefreshevery = 3;
+  uint32_t full = epd.fullrefreshes;
+  for(uint8_t i = 0; i < 6; i++){
+    publishOne();
+    uint32_t previouswrites = epd.previouswrites;
+    renderStep();
+    if(i == 2){ //the full one goes out as GxEPD2_BW::display(false) does: both RAMs, refresh, previous again
+      CHECK(epd.previouswrites == previouswrites + 2);
+      CHECK(!memcmp(display.epd2.previousRam(), display.epd2.currentRam(), GxEPD2_213_GDEY0213B74::RAM_BYTES));
+      CHECK(!display.epd2.poweredOn());
+    }
+  }
+  CHECK(epd.fullrefreshes == full + 2);
+  return checkResult("test_governor");
+}
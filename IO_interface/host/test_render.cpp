@@ -0,0 +1,198 @@
+/*
+Every screen against a committed golden image: bigText and drawEmpty, then drawMain and drawMainRipe from fixed
+frames for both sensor layouts in every LED mode and sense mode, a burst mean with whiskers and the waterfall
+before and after its ring wraps. Each screen goes out as a partial refresh on top of the one before, so the
+changed-area logic is covered too, and the panel as it looks afterwards is compared byte for byte with
+goldens/<name>.pbm. A screen that differs is written to build/render/<name>.pbm to look at. Every screen
+reports one pass, and the panel model sees one refresh for it. Changes far apart on a bar screen go out as
+separate windows, not one rectangle around them.
+
+  test_render       compare with the goldens
+  test_render -u    write the goldens (make goldens), after a change to a screen that is meant
+
+Render times are printed at the end for reference only, they are not part of the comparison.
+*/
+#include <spectroscopico.h>
+#include <stdio.h>
+#include <string>
+#include "check.h"
+#include "host.h"
+
+static bool update = false;
+static uint32_t screens = 0;
+static unsigned long screentime[2] = {}; //bar and text screens, waterfall
+static uint32_t screencount[2] = {};
+static uint32_t refreshes = 0; //panel refreshes up to the last screen
+
+static std::string readFile(const std::string &path){
+  std::string data;
+  FILE *f = fopen(path.c_str(), "rb");
+  if(!f) return data;
+  char buffer[4096];
+  size_t n;
+  while((n = fread(buffer, 1, sizeof(buffer), f)) > 0){data.append(buffer, n);}
+  fclose(f);
+  return data;
+}
+
+//the panel against goldens/<name>.pbm, or written there with -u
+static void compare(const std::string &name){
+  screens++;
+  std::string golden = "goldens/" + name + ".pbm";
+  if(update){
+    CHECK(display.epd2.hostWritePBM(golden.c_str()));
+    return;
+  }
+  std::string actual = "build/render/" + name + ".pbm";
+  CHECK(display.epd2.hostWritePBM(actual.c_str()));
+  std::string want = readFile(golden);
+  if(want.empty()){
+    fprintf(stderr, "%s: missing, run make goldens\n", golden.c_str());
+    CHECK(false);
+    return;
+  }
+  if(readFile(actual) != want){
+    fprintf(stderr, "%s: differs from %s\n", actual.c_str(), golden.c_str());
+    CHECK(false);
+    return;
+  }
+  remove(actual.c_str()); //only the differing ones are kept
+}
+
+//after every screen: one pass, one refresh, and its time for the summary
+static void timed(uint8_t kind){
+  const HostEPDStats &epd = display.epd2.stats;
+  CHECK(renderpasses == 1);
+  CHECK(epd.partialrefreshes + epd.fullrefreshes == refreshes + renderpasses);
+  refreshes = epd.partialrefreshes + epd.fullrefreshes;
+  screentime[kind] += rendertime;
+  screencount[kind]++;
+}
+
+//a fixed frame, different bars for every channel and every n
+static void testFrame(SpectralFrame &frame, uint8_t channels, uint16_t n){
+  memset(&frame, 0, sizeof(frame));
+  frame.channels = channels;
+  frame.sensor = (channels == 10) ? 2 : 1;
+  frame.shots = 1;
+  frame.timestamp = n + 1; //the waterfall takes each one as a new frame
+  for(uint8_t i = 0; i < channels; i++){
+    frame.values[i] = (q16_t)((i * 23 + n * 7 + 11) % 70) << 16;
+  }
+  normalise(frame);
+}
+
+static void renderLayout(uint8_t channels){
+  static const char *modenames[4] = {"single", "cont-off", "cont-on", "burst4"};
+  std::string layout = std::to_string(channels) + "ch";
+  SpectralFrame frame;
+  sensecon = (channels == 10) ? 2 : 1;
+  waterfall = false;
+  for(ledmode = 0; ledmode < 4; ledmode++){
+    for(uint8_t m = 0; m < 4; m++){ //single, continuous off, continuous on, burst
+      sensemode = (m == 0) ? 0 : (m == 3) ? 4 : 1;
+      cont_flag_draw = (m == 2);
+      std::string suffix = "_led" + std::to_string(ledmode) + "_" + modenames[m];
+      testFrame(frame, channels, m);
+      drawMain(false, detectColour(frame), frame);
+      timed(0);
+      compare(layout + "_main" + suffix);
+      drawMainRipe(false, bananaRipeness(frame), frame);
+      timed(0);
+      compare(layout + "_ripe" + suffix);
+    }
+  }
+
+  //burst mean with whiskers
+  ledmode = 1;
+  sensemode = 4;
+  cont_flag_draw = false;
+  testFrame(frame, channels, 4);
+  frame.shots = 4;
+  for(uint8_t i = 0; i < channels; i++){
+    frame.spread[i] = frame.values[i] / 8;
+  }
+  normalise(frame);
+  drawMain(false, detectColour(frame), frame);
+  timed(0);
+  compare(layout + "_main_whiskers");
+
+  //waterfall: the first frames, then past the ring wrap (fewer columns than the panel is wide)
+  sensemode = 1;
+  waterfall = true;
+  cont_flag_draw = true;
+  for(uint16_t n = 0; n < 250; n++){
+    testFrame(frame, channels, n);
+    drawWaterfall(false, frame);
+    timed(1);
+    if(n == 2){compare(layout + "_waterfall_3");}
+  }
+  compare(layout + "_waterfall_wrapped");
+  waterfall = false;
+}
+
+//the panel after a partial update is what a full redraw of the same screen gives
+static void checkSameAsFull(const String &toptext, const SpectralFrame &frame){
+  static uint8_t partial[GxEPD2_213_GDEY0213B74::RAM_BYTES];
+  memcpy(partial, display.epd2.panel(), sizeof(partial));
+  drawMain(true, toptext, frame);
+  CHECK(!memcmp(partial, display.epd2.panel(), sizeof(partial)));
+  refreshes = display.epd2.stats.partialrefreshes + display.epd2.stats.fullrefreshes;
+}
+
+//the first and last bar, then the title and one bar: a window each, a fraction of their bounding rectangle
+static void testChangedAreas(){
+  const uint32_t slotbytes = 2 * 16 * 14; //both RAMs, at most 16 bytes a row over a bar slot of up to 14 rows
+  const uint32_t bandbytes = 2 * 6 * 250; //both RAMs, the rows above the chart are the panel's last 6 bytes
+  SpectralFrame frame;
+  sensecon = 1;
+  ledmode = 1;
+  sensemode = 0;
+  cont_flag_draw = false;
+  waterfall = false;
+  testFrame(frame, 18, 0);
+  drawMain(false, "Test", frame);
+  timed(0);
+
+  frame.bars[0] = (frame.bars[0] + 30) % 70;
+  frame.bars[17] = (frame.bars[17] + 30) % 70;
+  drawMain(false, "Test", frame);
+  timed(0);
+  CHECK(renderbytes <= 2 * slotbytes);
+  checkSameAsFull("Test", frame);
+
+  frame.bars[8] = (frame.bars[8] + 30) % 70;
+  drawMain(false, "Changed", frame);
+  timed(0);
+  CHECK(renderbytes <= bandbytes + slotbytes);
+  CHECK(renderbytes < 2 * GxEPD2_213_GDEY0213B74::RAM_BYTES / 2);
+  checkSameAsFull("Changed", frame);
+}
+
+int main(int argc, char **argv){
+  update = (argc > 1 && !strcmp(argv[1], "-u"));
+  system("mkdir -p build/render");
+  setup(); //no sensor on the bus: the "No Sensor Detected" text, then "Booted"
+  CHECK(booted);
+  CHECK(sensecon == 0);
+  refreshes = display.epd2.stats.partialrefreshes + display.epd2.stats.fullrefreshes;
+
+  bigText(false, "No Sensor Detected, Generating Random Results");
+  CHECK(renderbytes == 2 * GxEPD2_213_GDEY0213B74::RAM_BYTES);
+  timed(0);
+  compare("bigText");
+  ledmode = 1;
+  sensemode = 0;
+  drawEmpty(false, "Booted");
+  timed(0);
+  compare("drawEmpty");
+
+  renderLayout(18);
+  renderLayout(10);
+  testChangedAreas();
+
+  if(update){printf("test_render: %u goldens written\n", screens);}
+  printf("test_render: bar and text screens %lu us, waterfall %lu us on average (virtual time, not compared)\n",
+         screentime[0] / screencount[0], screentime[1] / screencount[1]);
+  return checkResult("test_render");
+}
@@ -0,0 +1,119 @@
+"""
+Packs the 1-bit UI bitmaps of Firmware_v1_1 into packed_bitmaps.h for drawPackedBitmap() (packed_bitmap.h).
+
+Each bitmap is a `const unsigned char name[] = {...}` array in one of the firmware headers, in Adafruit
+drawBitmap layout. Every run of identical rows is stored once as a count byte (repeats, 0-127) followed by
+the row PackBits-encoded. The output is decoded again and compared with the input before it is written.
+
+Run from anywhere after editing a bitmap header:
+    python3 pack_bitmaps.py
+"""
+import os
+import re
+
+FIRMWARE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Firmware_v1_1")
+OUTPUT = "packed_bitmaps.h"
+
+# (header, array, width, height) - the sizes drawBitmap() was called with
+BITMAPS = [
+    ("18chanbase.h", "base18", 245, 91),
+    ("10chanbase.h", "base10", 246, 90),
+    ("ripescale.h", "ripescale", 170, 16),
+]
+
+
+def read_array(header, name):
+    with open(os.path.join(FIRMWARE, header)) as f:
+        text = f.read()
+    match = re.search(r"const\s+unsigned\s+char\s+" + name + r"\s*\[\s*\]\s*=\s*\{([^}]*)\}", text)
+    if not match:
+        raise SystemExit("%s not found in %s" % (name, header))
+    return [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", match.group(1))]
+
+
+def packbits(row):
+    out = []
+    i = 0
+    while i < len(row):
+        run = 1
+        while i + run < len(row) and run < 128 and row[i + run] == row[i]:
+            run += 1
+        if run >= 3:
+            out += [257 - run, row[i]]
+            i += run
+            continue
+        start = i
+        while i < len(row) and i - start < 128:
+            if i + 2 < len(row) and row[i] == row[i + 1] == row[i + 2]:
+                break
+            i += 1
+        out += [i - start - 1] + row[start:i]
+    return out
+
+
+def pack(data, width, height):
+    stride = (width + 7) // 8
+    if stride > 32:
+        raise SystemExit("rows wider than PACKED_MAX_ROW_BYTES")
+    if len(data) < stride * height:
+        raise SystemExit("array shorter than %dx%d" % (width, height))
+    rows = [data[y * stride:(y + 1) * stride] for y in range(height)]
+    out = []
+    y = 0
+    while y < height:
+        repeats = 0
+        while y + repeats + 1 < height and repeats < 127 and rows[y + repeats + 1] == rows[y]:
+            repeats += 1
+        out += [repeats] + packbits(rows[y])
+        y += repeats + 1
+    return out
+
+
+def unpack(packed, width, height):
+    stride = (width + 7) // 8
+    rows = []
+    i = 0
+    while len(rows) < height:
+        repeats = packed[i]
+        i += 1
+        row = []
+        while len(row) < stride:
+            n = packed[i]
+            i += 1
+            if n < 128:
+                row += packed[i:i + n + 1]
+                i += n + 1
+            elif n > 128:
+                row += [packed[i]] * (257 - n)
+                i += 1
+        rows += [row] * (repeats + 1)
+    return [b for row in rows[:height] for b in row]
+
+
+def main():
+    lines = [
+        "#ifndef _PACKED_BITMAPS_H",
+        "#define _PACKED_BITMAPS_H",
+        "",
+        "//generated by IO_interface/tools/pack_bitmaps.py from the bitmap headers, edit those and re-run it",
+        '#include "packed_bitmap.h"',
+        "",
+    ]
+    for header, name, width, height in BITMAPS:
+        data = read_array(header, name)
+        packed = pack(data, width, height)
+        stride = (width + 7) // 8
+        if unpack(packed, width, height) != data[:stride * height]:
+            raise SystemExit("%s does not round trip" % name)
+        print("%-10s %5d -> %4d bytes" % (name, stride * height, len(packed)))
+        body = ",".join("0x%02x" % v for v in packed)
+        lines.append("const uint8_t %s_data[] = {%s};" % (name, body))
+        lines.append("const PackedBitmap %s_packed = {%s_data, %d, %d}; //from %s" % (name, name, width, height, header))
+        lines.append("")
+    lines.append("#endif")
+    with open(os.path.join(FIRMWARE, OUTPUT), "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -28,6 +28,10 @@
 #
 ******************************************************************************/
 #include "DEV_Config.h"
+#if DEV_SPI_DMA
+#include <hardware/dma.h>
+#include <hardware/spi.h>
+#endif
 
 void GPIO_Config(void)
 {
@@ -101,10 +105,54 @@ void DEV_SPI_WriteByte(UBYTE data)
     SPI1.transfer(data);
 }
 
+/******************************************************************************
+function:	Write a block of bytes, CS and DC are left to the caller
+parameter:
+	pData : bytes to send
+	len   : number of bytes
+Info:
+	One call for the whole block instead of a transfer per byte. With DEV_SPI_DMA
+	a DMA channel paced by the SPI1 TX DREQ streams it and the CPU only waits
+	for the end
+******************************************************************************/
+#if DEV_SPI_DMA
+static int DEV_SPI_DMA_Channel = -1;
+
+void DEV_SPI_Write_nByte(UBYTE *pData, UDOUBLE len)
+{
+    if (DEV_SPI_DMA_Channel < 0)
+        DEV_SPI_DMA_Channel = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(DEV_SPI_DMA_Channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, spi_get_index(spi1) ? DREQ_SPI1_TX : DREQ_SPI0_TX);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure(DEV_SPI_DMA_Channel, &c, &spi_get_hw(spi1)->dr, pData, len, true);
+    dma_channel_wait_for_finish_blocking(DEV_SPI_DMA_Channel);
+
+    while (spi_is_busy(spi1)) //last byte still shifting out
+        ;
+    while (spi_is_readable(spi1)) //nothing reads RX during the DMA, drop what came back
+        (void)spi_get_hw(spi1)->dr;
+    spi_get_hw(spi1)->icr = SPI_SSPICR_RORIC_BITS; //clear the RX overrun
+}
+#else
 void DEV_SPI_Write_nByte(UBYTE *pData, UDOUBLE len)
 {
-    for (int i = 0; i < len; i++)
-        DEV_SPI_WriteByte(pData[i]);
+    SPI1.transfer(pData, NULL, len);
+}
+#endif
+
+/******************************************************************************
+function:	Temperature for the e-Paper waveform choice, in degrees C
+Info:
+	The panel's own sensor can't be read back without MISO, the RP2040 one
+	sits next to it on the board
+******************************************************************************/
+int DEV_Read_Temperature(void)
+{
+    return (int)(analogReadTemp() + 0.5f);
 }
 
 // void DEV_SPI_SendByte(UBYTE data)
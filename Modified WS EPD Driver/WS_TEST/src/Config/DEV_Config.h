@@ -64,6 +64,12 @@
 #define GPIO_PIN_SET   1
 #define GPIO_PIN_RESET 0
 
+/**
+ * SPI block transfers
+ * 0: SPI1.transfer(buffer) in one call, 1: pico DMA channel feeding the SPI1 TX FIFO
+**/
+#define DEV_SPI_DMA 0
+
 /**
  * GPIO read and write
 **/
@@ -85,5 +91,6 @@ void DEV_SPI_WriteByte(UBYTE data);
 void DEV_SPI_SendByte(UBYTE data);
 UBYTE DEV_SPI_ReadByte();
 void DEV_SPI_Write_nByte(UBYTE *pData, UDOUBLE len);
+int DEV_Read_Temperature(void);
 void DEV_Module_Exit(void);
 #endif
@@ -131,7 +131,7 @@ int EPD_2in13_V4_test(void)
         if(num == 0) {
             break;
         }
-		EPD_2in13_V4_Display_Partial(BlackImage);
+		EPD_2in13_V4_Display_Diff(BlackImage); //only the digits that changed, ~100 bytes a second
         DEV_Delay_ms(500);//Analog clock 1s
     }
 #endif
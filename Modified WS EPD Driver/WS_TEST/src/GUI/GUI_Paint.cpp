@@ -83,6 +83,219 @@
 
 PAINT Paint;
 
+/******************************************************************************
+function: Pixel writers, one per rotation, mirroring and pixel size, so none
+          of them switches on the image settings. Paint_SelectWriter picks the
+          writer and the loops built on it for the current image whenever
+          those settings change
+parameter:
+    Xpoint : At point X, inside the image
+    Ypoint : At point Y, inside the image
+    Color  : Painted colors
+******************************************************************************/
+template<UWORD Rotate, UBYTE Mirror, UBYTE Bits>
+static void Paint_WritePixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+{
+    UWORD X, Y;
+    if(Rotate == 90) {
+        X = Paint.WidthMemory - Ypoint - 1;
+        Y = Xpoint;
+    }else if(Rotate == 180) {
+        X = Paint.WidthMemory - Xpoint - 1;
+        Y = Paint.HeightMemory - Ypoint - 1;
+    }else if(Rotate == 270) {
+        X = Ypoint;
+        Y = Paint.HeightMemory - Xpoint - 1;
+    }else {
+        X = Xpoint;
+        Y = Ypoint;
+    }
+    if(Mirror & MIRROR_HORIZONTAL)
+        X = Paint.WidthMemory - X - 1;
+    if(Mirror & MIRROR_VERTICAL)
+        Y = Paint.HeightMemory - Y - 1;
+
+    if(Bits == 1) {
+        UDOUBLE Addr = X / 8 + Y * Paint.WidthByte;
+        if(Color == BLACK)
+            Paint.Image[Addr] &= ~(0x80 >> (X % 8));
+        else
+            Paint.Image[Addr] |= 0x80 >> (X % 8);
+    }else if(Bits == 2) {
+        UDOUBLE Addr = X / 4 + Y * Paint.WidthByte;
+        UBYTE Shift = 6 - (X % 4) * 2;
+        Paint.Image[Addr] = (Paint.Image[Addr] & ~(0x03 << Shift)) | ((Color % 4) << Shift);
+    }else {
+        UDOUBLE Addr = X / 2 + Y * Paint.WidthByte;
+        UBYTE Shift = 4 - (X % 2) * 4;
+        Paint.Image[Addr] = (Paint.Image[Addr] & ~(0x0F << Shift)) | ((Color & 0x0F) << Shift);
+    }
+}
+
+/******************************************************************************
+function: The loops that plot single pixels, templated on the writer so each
+          pixel is a direct (inlined) write. Plot gets the point as the
+          drawing functions pass it to Paint_DrawPoint
+******************************************************************************/
+template<class Plot>
+static void Paint_LineLoop(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, LINE_STYLE Line_Style, Plot Point)
+{
+    UWORD Xpoint = Xstart;
+    UWORD Ypoint = Ystart;
+    int dx = (int)Xend - (int)Xstart >= 0 ? Xend - Xstart : Xstart - Xend;
+    int dy = (int)Yend - (int)Ystart <= 0 ? Yend - Ystart : Ystart - Yend;
+
+    // Increment direction, 1 is positive, -1 is counter;
+    int XAddway = Xstart < Xend ? 1 : -1;
+    int YAddway = Ystart < Yend ? 1 : -1;
+
+    //Cumulative error
+    int Esp = dx + dy;
+    char Dotted_Len = 0;
+
+    for (;;) {
+        Dotted_Len++;
+        //Painted dotted line, 2 point is really virtual
+        if (Line_Style == LINE_STYLE_DOTTED && Dotted_Len % 3 == 0) {
+            Point(Xpoint, Ypoint, true);
+            Dotted_Len = 0;
+        } else {
+            Point(Xpoint, Ypoint, false);
+        }
+        if (2 * Esp >= dy) {
+            if (Xpoint == Xend)
+                break;
+            Esp += dy;
+            Xpoint += XAddway;
+        }
+        if (2 * Esp <= dx) {
+            if (Ypoint == Yend)
+                break;
+            Esp += dx;
+            Ypoint += YAddway;
+        }
+    }
+}
+
+template<class Plot>
+static void Paint_CircleLoop(UWORD X_Center, UWORD Y_Center, UWORD Radius, Plot Point)
+{
+    //Draw a circle from(0, R) as a starting point
+    int16_t XCurrent = 0, YCurrent = Radius;
+
+    //Cumulative error,judge the next point of the logo
+    int16_t Esp = 3 - (Radius << 1 );
+
+    while (XCurrent <= YCurrent ) {
+        Point(X_Center + XCurrent, Y_Center + YCurrent);//1
+        Point(X_Center - XCurrent, Y_Center + YCurrent);//2
+        Point(X_Center - YCurrent, Y_Center + XCurrent);//3
+        Point(X_Center - YCurrent, Y_Center - XCurrent);//4
+        Point(X_Center - XCurrent, Y_Center - YCurrent);//5
+        Point(X_Center + XCurrent, Y_Center - YCurrent);//6
+        Point(X_Center + YCurrent, Y_Center - XCurrent);//7
+        Point(X_Center + YCurrent, Y_Center + XCurrent);//0
+
+        if (Esp < 0 )
+            Esp += 4 * XCurrent + 6;
+        else {
+            Esp += 10 + 4 * (XCurrent - YCurrent );
+            YCurrent --;
+        }
+        XCurrent ++;
+    }
+}
+
+//1 pixel lines and hollow circles: each 1x1 point one up and left, as Paint_DrawPoint puts it
+template<UWORD Rotate, UBYTE Mirror, UBYTE Bits>
+static void Paint_LineRun(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color, LINE_STYLE Line_Style)
+{
+    Paint_LineLoop(Xstart, Ystart, Xend, Yend, Line_Style, [Color](UWORD Xpoint, UWORD Ypoint, bool Gap) {
+        if (Xpoint >= 1 && Ypoint >= 1) //the ends are checked against the image, the points in between are in it
+            Paint_WritePixel<Rotate, Mirror, Bits>(Xpoint - 1, Ypoint - 1, Gap ? IMAGE_BACKGROUND : Color);
+    });
+}
+
+template<UWORD Rotate, UBYTE Mirror, UBYTE Bits>
+static void Paint_CircleRun(UWORD X_Center, UWORD Y_Center, UWORD Radius, UWORD Color)
+{
+    Paint_CircleLoop(X_Center, Y_Center, Radius, [Color](int Xpoint, int Ypoint) {
+        if (Xpoint >= 1 && Ypoint >= 1 && Xpoint <= Paint.Width && Ypoint <= Paint.Height)
+            Paint_WritePixel<Rotate, Mirror, Bits>(Xpoint - 1, Ypoint - 1, Color);
+    });
+}
+
+template<UWORD Rotate, UBYTE Mirror, UBYTE Bits>
+static void Paint_PasteRun(const unsigned char* image_buffer, UWORD xStart, UWORD yStart,
+                           UWORD imageWidth, UWORD imageHeight, UBYTE flipColor)
+{
+    UBYTE color, srcImage;
+    UWORD x, y;
+    UWORD width = (imageWidth%8==0 ? imageWidth/8 : imageWidth/8+1);
+
+    for (y = 0; y < imageHeight && y + yStart < Paint.Height; y++) {
+        for (x = 0; x < imageWidth && x + xStart < Paint.Width; x++) {
+            srcImage = image_buffer[y*width + x/8];
+            if(flipColor)
+                color = (((srcImage<<(x%8) & 0x80) == 0) ? 1 : 0);
+            else
+                color = (((srcImage<<(x%8) & 0x80) == 0) ? 0 : 1);
+            Paint_WritePixel<Rotate, Mirror, Bits>(x+xStart, y+yStart, color);
+        }
+    }
+}
+
+//scales GUI_Paint does not draw
+static void Paint_WriteNothing(UWORD, UWORD, UWORD)
+{
+}
+
+static void Paint_LineNothing(UWORD, UWORD, UWORD, UWORD, UWORD, LINE_STYLE)
+{
+}
+
+static void Paint_CircleNothing(UWORD, UWORD, UWORD, UWORD)
+{
+}
+
+static void Paint_PasteNothing(const unsigned char*, UWORD, UWORD, UWORD, UWORD, UBYTE)
+{
+}
+
+typedef struct {
+    void (*Pixel)(UWORD, UWORD, UWORD);
+    void (*Line)(UWORD, UWORD, UWORD, UWORD, UWORD, LINE_STYLE);
+    void (*Circle)(UWORD, UWORD, UWORD, UWORD);
+    void (*Paste)(const unsigned char*, UWORD, UWORD, UWORD, UWORD, UBYTE);
+} PAINT_WRITER;
+
+#define PAINT_WRITER_OF(R, M, B) {Paint_WritePixel<R, M, B>, Paint_LineRun<R, M, B>, Paint_CircleRun<R, M, B>, Paint_PasteRun<R, M, B>}
+#define PAINT_WRITERS_BITS(R, M) {PAINT_WRITER_OF(R, M, 1), PAINT_WRITER_OF(R, M, 2), PAINT_WRITER_OF(R, M, 4)}
+#define PAINT_WRITERS(R) {PAINT_WRITERS_BITS(R, MIRROR_NONE), PAINT_WRITERS_BITS(R, MIRROR_HORIZONTAL), \
+                          PAINT_WRITERS_BITS(R, MIRROR_VERTICAL), PAINT_WRITERS_BITS(R, MIRROR_ORIGIN)}
+static const PAINT_WRITER Paint_Writers[4][4][3] = {
+    PAINT_WRITERS(ROTATE_0), PAINT_WRITERS(ROTATE_90), PAINT_WRITERS(ROTATE_180), PAINT_WRITERS(ROTATE_270),
+};
+static const PAINT_WRITER Paint_NoWriter = {Paint_WriteNothing, Paint_LineNothing, Paint_CircleNothing, Paint_PasteNothing};
+
+static const PAINT_WRITER *Paint_Writer = &Paint_Writers[0][0][0];
+
+static void Paint_SelectWriter(void)
+{
+    UBYTE Bits;
+    if(Paint.Scale == 2)
+        Bits = 0;
+    else if(Paint.Scale == 4)
+        Bits = 1;
+    else if(Paint.Scale == 6 || Paint.Scale == 7 || Paint.Scale == 16)
+        Bits = 2;
+    else {
+        Paint_Writer = &Paint_NoWriter;
+        return;
+    }
+    Paint_Writer = &Paint_Writers[(Paint.Rotate / 90) % 4][Paint.Mirror % 4][Bits];
+}
+
 /******************************************************************************
 function: Create Image
 parameter:
@@ -115,6 +328,7 @@ void Paint_NewImage(UBYTE *image, UWORD Width, UWORD Height, UWORD Rotate, UWORD
         Paint.Width = Height;
         Paint.Height = Width;
     }
+    Paint_SelectWriter();
 }
 
 /******************************************************************************
@@ -137,6 +351,7 @@ void Paint_SetRotate(UWORD Rotate)
     if(Rotate == ROTATE_0 || Rotate == ROTATE_90 || Rotate == ROTATE_180 || Rotate == ROTATE_270) {
         // Debug("Set image Rotate %d\r\n", Rotate);
         Paint.Rotate = Rotate;
+        Paint_SelectWriter();
     } else {
         Debug("rotate = 0, 90, 180, 270\r\n");
     }
@@ -153,6 +368,7 @@ void Paint_SetMirroring(UBYTE mirror)
         mirror == MIRROR_VERTICAL || mirror == MIRROR_ORIGIN) {
         // Debug("mirror image x:%s, y:%s\r\n",(mirror & 0x01)? "mirror":"none", ((mirror >> 1) & 0x01)? "mirror":"none");
         Paint.Mirror = mirror;
+        Paint_SelectWriter();
     } else {
         Debug("mirror should be MIRROR_NONE, MIRROR_HORIZONTAL, \
         MIRROR_VERTICAL or MIRROR_ORIGIN\r\n");
@@ -177,6 +393,7 @@ void Paint_SetScale(UBYTE scale)
         Debug("Set Scale Input parameter error\r\n");
         Debug("Scale Only support: 2 4 7\r\n");
     }
+    Paint_SelectWriter();
 }
 /******************************************************************************
 function: Draw Pixels
@@ -187,75 +404,119 @@ parameter:
 ******************************************************************************/
 void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
 {
-    if(Xpoint > Paint.Width || Ypoint > Paint.Height){
+    if(Xpoint >= Paint.Width || Ypoint >= Paint.Height){
         Debug("Exceeding display boundaries\r\n");
         return;
-    }      
-    UWORD X, Y;
+    }
+    Paint_Writer->Pixel(Xpoint, Ypoint, Color);
+}
+
+/******************************************************************************
+function: Map a point to the image memory, as Paint_SetPixel does
+parameter:
+    Xpoint : At point X, replaced by the memory column
+    Ypoint : At point Y, replaced by the memory row
+******************************************************************************/
+static void Paint_MapPoint(UWORD *Xpoint, UWORD *Ypoint)
+{
+    UWORD X = *Xpoint, Y = *Ypoint;
     switch(Paint.Rotate) {
-    case 0:
-        X = Xpoint;
-        Y = Ypoint;  
-        break;
     case 90:
-        X = Paint.WidthMemory - Ypoint - 1;
-        Y = Xpoint;
+        X = Paint.WidthMemory - *Ypoint - 1;
+        Y = *Xpoint;
         break;
     case 180:
-        X = Paint.WidthMemory - Xpoint - 1;
-        Y = Paint.HeightMemory - Ypoint - 1;
+        X = Paint.WidthMemory - *Xpoint - 1;
+        Y = Paint.HeightMemory - *Ypoint - 1;
         break;
     case 270:
-        X = Ypoint;
-        Y = Paint.HeightMemory - Xpoint - 1;
+        X = *Ypoint;
+        Y = Paint.HeightMemory - *Xpoint - 1;
         break;
     default:
-        return;
-    }
-    
-    switch(Paint.Mirror) {
-    case MIRROR_NONE:
-        break;
-    case MIRROR_HORIZONTAL:
-        X = Paint.WidthMemory - X - 1;
-        break;
-    case MIRROR_VERTICAL:
-        Y = Paint.HeightMemory - Y - 1;
         break;
-    case MIRROR_ORIGIN:
+    }
+    if(Paint.Mirror == MIRROR_HORIZONTAL || Paint.Mirror == MIRROR_ORIGIN)
         X = Paint.WidthMemory - X - 1;
+    if(Paint.Mirror == MIRROR_VERTICAL || Paint.Mirror == MIRROR_ORIGIN)
         Y = Paint.HeightMemory - Y - 1;
-        break;
-    default:
+    *Xpoint = X;
+    *Ypoint = Y;
+}
+
+/******************************************************************************
+function: Fill pixels X0..X1 of one memory row
+parameter:
+    Row  : first byte of the row
+    X0   : first pixel
+    X1   : last pixel
+    Bits : bits per pixel, 1 2 or 4
+    Fill : the color repeated over a whole byte
+******************************************************************************/
+static void Paint_FillRow(UBYTE *Row, UWORD X0, UWORD X1, UBYTE Bits, UBYTE Fill)
+{
+    UWORD Per = 8 / Bits;
+    UWORD B0 = X0 / Per, B1 = X1 / Per;
+    UBYTE M0 = 0xFF >> ((X0 % Per) * Bits);             //X0 to the end of its byte
+    UBYTE M1 = 0xFF << ((Per - 1 - X1 % Per) * Bits);   //start of the byte to X1
+
+    if(B0 == B1) {
+        M0 &= M1;
+        Row[B0] = (Row[B0] & ~M0) | (Fill & M0);
         return;
     }
+    Row[B0] = (Row[B0] & ~M0) | (Fill & M0);
+    memset(Row + B0 + 1, Fill, B1 - B0 - 1); //whole bytes in between
+    Row[B1] = (Row[B1] & ~M1) | (Fill & M1);
+}
 
-    if(X > Paint.WidthMemory || Y > Paint.HeightMemory){
-        Debug("Exceeding display boundaries\r\n");
+/******************************************************************************
+function: Fill a rectangle, the span primitive under the fills and straight lines.
+          Clipped to the image, one masked edge byte at each end and memset in
+          between for every memory row, instead of Paint_SetPixel per pixel
+parameter:
+    Xstart : x starting point
+    Ystart : Y starting point
+    Xend   : x end point, included
+    Yend   : y end point, included
+    Color  : Painted colors
+******************************************************************************/
+static void Paint_FillSpan(int Xstart, int Ystart, int Xend, int Yend, UWORD Color)
+{
+    if(Xstart < 0)
+        Xstart = 0;
+    if(Ystart < 0)
+        Ystart = 0;
+    if(Xend > Paint.Width - 1)
+        Xend = Paint.Width - 1;
+    if(Yend > Paint.Height - 1)
+        Yend = Paint.Height - 1;
+    if(Xstart > Xend || Ystart > Yend)
+        return;
+
+    //a rectangle stays a rectangle through rotation and mirroring
+    UWORD X0 = Xstart, Y0 = Ystart, X1 = Xend, Y1 = Yend;
+    Paint_MapPoint(&X0, &Y0);
+    Paint_MapPoint(&X1, &Y1);
+    if(X0 > X1) { UWORD t = X0; X0 = X1; X1 = t; }
+    if(Y0 > Y1) { UWORD t = Y0; Y0 = Y1; Y1 = t; }
+
+    UBYTE Bits, Fill;
+    if(Paint.Scale == 2) {
+        Bits = 1;
+        Fill = (Color == BLACK)? 0x00 : 0xFF;
+    }else if(Paint.Scale == 4) {
+        Bits = 2;
+        Fill = (Color % 4) * 0x55;
+    }else if(Paint.Scale == 6 || Paint.Scale == 7 || Paint.Scale == 16) {
+        Bits = 4;
+        Fill = (Color & 0x0F) * 0x11;
+    }else {
         return;
     }
-    
-    if(Paint.Scale == 2){
-        UDOUBLE Addr = X / 8 + Y * Paint.WidthByte;
-        UBYTE Rdata = Paint.Image[Addr];
-        if(Color == BLACK)
-            Paint.Image[Addr] = Rdata & ~(0x80 >> (X % 8));
-        else
-            Paint.Image[Addr] = Rdata | (0x80 >> (X % 8));
-    }else if(Paint.Scale == 4){
-        UDOUBLE Addr = X / 4 + Y * Paint.WidthByte;
-        Color = Color % 4;//Guaranteed color scale is 4  --- 0~3
-        UBYTE Rdata = Paint.Image[Addr];
-        
-        Rdata = Rdata & (~(0xC0 >> ((X % 4)*2)));
-        Paint.Image[Addr] = Rdata | ((Color << 6) >> ((X % 4)*2));
-    }else if(Paint.Scale == 6 || Paint.Scale == 7 || Paint.Scale == 16){
-		UDOUBLE Addr = X / 2  + Y * Paint.WidthByte;
-		UBYTE Rdata = Paint.Image[Addr];
-		Rdata = Rdata & (~(0xF0 >> ((X % 2)*4)));//Clear first, then set value
-		Paint.Image[Addr] = Rdata | ((Color << 4) >> ((X % 2)*4));
-		// printf("Add =  %d ,data = %d\r\n",Addr,Rdata);	
-    }
+
+    for (UWORD Y = Y0; Y <= Y1; Y++)
+        Paint_FillRow(Paint.Image + (UDOUBLE)Y * Paint.WidthByte, X0, X1, Bits, Fill);
 }
 
 /******************************************************************************
@@ -265,28 +526,17 @@ parameter:
 ******************************************************************************/
 void Paint_Clear(UWORD Color)
 {
+    UBYTE Fill;
     if(Paint.Scale == 2) {
-		for (UWORD Y = 0; Y < Paint.HeightByte; Y++) {
-			for (UWORD X = 0; X < Paint.WidthByte; X++ ) {//8 pixel =  1 byte
-				UDOUBLE Addr = X + Y*Paint.WidthByte;
-				Paint.Image[Addr] = Color;
-			}
-		}
+        Fill = Color;
     }else if(Paint.Scale == 4) {
-        for (UWORD Y = 0; Y < Paint.HeightByte; Y++) {
-            for (UWORD X = 0; X < Paint.WidthByte; X++ ) {
-                UDOUBLE Addr = X + Y*Paint.WidthByte;
-                Paint.Image[Addr] = (Color<<6)|(Color<<4)|(Color<<2)|Color;
-            }
-        }
+        Fill = (Color<<6)|(Color<<4)|(Color<<2)|Color;
     }else if(Paint.Scale == 6 || Paint.Scale == 7 || Paint.Scale == 16) {
-		for (UWORD Y = 0; Y < Paint.HeightByte; Y++) {
-			for (UWORD X = 0; X < Paint.WidthByte; X++ ) {
-				UDOUBLE Addr = X + Y*Paint.WidthByte;
-				Paint.Image[Addr] = (Color<<4)|Color;
-			}
-		}		
-	}
+        Fill = (Color<<4)|Color;
+    }else {
+        return;
+    }
+    memset(Paint.Image, Fill, (UDOUBLE)Paint.WidthByte * Paint.HeightByte);
 }
 
 /******************************************************************************
@@ -300,12 +550,7 @@ parameter:
 ******************************************************************************/
 void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
 {
-    UWORD X, Y;
-    for (Y = Ystart; Y < Yend; Y++) {
-        for (X = Xstart; X < Xend; X++) {//8 pixel =  1 byte
-            Paint_SetPixel(X, Y, Color);
-        }
-    }
+    Paint_FillSpan(Xstart, Ystart, (int)Xend - 1, (int)Yend - 1, Color);
 }
 
 /******************************************************************************
@@ -325,22 +570,17 @@ void Paint_DrawPoint(UWORD Xpoint, UWORD Ypoint, UWORD Color,
         return;
     }
 
-    int16_t XDir_Num , YDir_Num;
+    if (Dot_Pixel == DOT_PIXEL_1X1) { //both styles put it one up and left, most line and circle points
+        if (Xpoint >= 1 && Ypoint >= 1 && Xpoint <= Paint.Width && Ypoint <= Paint.Height)
+            Paint_Writer->Pixel(Xpoint - 1, Ypoint - 1, Color);
+        return;
+    }
     if (Dot_Style == DOT_FILL_AROUND) {
-        for (XDir_Num = 0; XDir_Num < 2 * Dot_Pixel - 1; XDir_Num++) {
-            for (YDir_Num = 0; YDir_Num < 2 * Dot_Pixel - 1; YDir_Num++) {
-                if(Xpoint + XDir_Num - Dot_Pixel < 0 || Ypoint + YDir_Num - Dot_Pixel < 0)
-                    break;
-                // printf("x = %d, y = %d\r\n", Xpoint + XDir_Num - Dot_Pixel, Ypoint + YDir_Num - Dot_Pixel);
-                Paint_SetPixel(Xpoint + XDir_Num - Dot_Pixel, Ypoint + YDir_Num - Dot_Pixel, Color);
-            }
-        }
+        if (Ypoint < Dot_Pixel) //the square is dropped once its top leaves the image
+            return;
+        Paint_FillSpan(Xpoint - Dot_Pixel, Ypoint - Dot_Pixel, Xpoint + Dot_Pixel - 2, Ypoint + Dot_Pixel - 2, Color);
     } else {
-        for (XDir_Num = 0; XDir_Num <  Dot_Pixel; XDir_Num++) {
-            for (YDir_Num = 0; YDir_Num <  Dot_Pixel; YDir_Num++) {
-                Paint_SetPixel(Xpoint + XDir_Num - 1, Ypoint + YDir_Num - 1, Color);
-            }
-        }
+        Paint_FillSpan(Xpoint - 1, Ypoint - 1, Xpoint + Dot_Pixel - 2, Ypoint + Dot_Pixel - 2, Color);
     }
 }
 
@@ -364,42 +604,25 @@ void Paint_DrawLine(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
         return;
     }
 
-    UWORD Xpoint = Xstart;
-    UWORD Ypoint = Ystart;
-    int dx = (int)Xend - (int)Xstart >= 0 ? Xend - Xstart : Xstart - Xend;
-    int dy = (int)Yend - (int)Ystart <= 0 ? Yend - Ystart : Ystart - Yend;
-
-    // Increment direction, 1 is positive, -1 is counter;
-    int XAddway = Xstart < Xend ? 1 : -1;
-    int YAddway = Ystart < Yend ? 1 : -1;
-
-    //Cumulative error
-    int Esp = dx + dy;
-    char Dotted_Len = 0;
+    //straight solid lines are one span: the union of the points' squares
+    if (Line_Style == LINE_STYLE_SOLID && (Xstart == Xend || Ystart == Yend)) {
+        int X0 = Xstart < Xend ? Xstart : Xend, X1 = Xstart < Xend ? Xend : Xstart;
+        int Y0 = Ystart < Yend ? Ystart : Yend, Y1 = Ystart < Yend ? Yend : Ystart;
+        if (Y1 < Line_width)
+            return;
+        if (Y0 < Line_width)
+            Y0 = Line_width;
+        Paint_FillSpan(X0 - Line_width, Y0 - Line_width, X1 + Line_width - 2, Y1 + Line_width - 2, Color);
+        return;
+    }
 
-    for (;;) {
-        Dotted_Len++;
-        //Painted dotted line, 2 point is really virtual
-        if (Line_Style == LINE_STYLE_DOTTED && Dotted_Len % 3 == 0) {
-            //Debug("LINE_DOTTED\r\n");
-            Paint_DrawPoint(Xpoint, Ypoint, IMAGE_BACKGROUND, Line_width, DOT_STYLE_DFT);
-            Dotted_Len = 0;
-        } else {
-            Paint_DrawPoint(Xpoint, Ypoint, Color, Line_width, DOT_STYLE_DFT);
-        }
-        if (2 * Esp >= dy) {
-            if (Xpoint == Xend)
-                break;
-            Esp += dy;
-            Xpoint += XAddway;
-        }
-        if (2 * Esp <= dx) {
-            if (Ypoint == Yend)
-                break;
-            Esp += dx;
-            Ypoint += YAddway;
-        }
+    if (Line_width == DOT_PIXEL_1X1) {
+        Paint_Writer->Line(Xstart, Ystart, Xend, Yend, Color, Line_Style);
+        return;
     }
+    Paint_LineLoop(Xstart, Ystart, Xend, Yend, Line_Style, [Color, Line_width](UWORD Xpoint, UWORD Ypoint, bool Gap) {
+        Paint_DrawPoint(Xpoint, Ypoint, Gap ? IMAGE_BACKGROUND : Color, Line_width, DOT_STYLE_DFT);
+    });
 }
 
 /******************************************************************************
@@ -423,10 +646,12 @@ void Paint_DrawRectangle(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
     }
 
     if (Draw_Fill) {
-        UWORD Ypoint;
-        for(Ypoint = Ystart; Ypoint < Yend; Ypoint++) {
-            Paint_DrawLine(Xstart, Ypoint, Xend, Ypoint, Color , Line_width, LINE_STYLE_SOLID);
-        }
+        //the rows Ystart..Yend-1 as lines, in one span
+        int X0 = Xstart < Xend ? Xstart : Xend, X1 = Xstart < Xend ? Xend : Xstart;
+        int Y0 = Ystart < Line_width ? (int)Line_width : Ystart;
+        if (Yend <= Ystart || Yend - 1 < Line_width)
+            return;
+        Paint_FillSpan(X0 - Line_width, Y0 - Line_width, X1 + Line_width - 2, Yend + Line_width - 3, Color);
     } else {
         Paint_DrawLine(Xstart, Ystart, Xend, Ystart, Color, Line_width, LINE_STYLE_SOLID);
         Paint_DrawLine(Xstart, Ystart, Xstart, Yend, Color, Line_width, LINE_STYLE_SOLID);
@@ -462,19 +687,18 @@ void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius,
     //Cumulative error,judge the next point of the logo
     int16_t Esp = 3 - (Radius << 1 );
 
-    int16_t sCountY;
     if (Draw_Fill == DRAW_FILL_FULL) {
         while (XCurrent <= YCurrent ) { //Realistic circles
-            for (sCountY = XCurrent; sCountY <= YCurrent; sCountY ++ ) {
-                Paint_DrawPoint(X_Center + XCurrent, Y_Center + sCountY, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//1
-                Paint_DrawPoint(X_Center - XCurrent, Y_Center + sCountY, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//2
-                Paint_DrawPoint(X_Center - sCountY, Y_Center + XCurrent, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//3
-                Paint_DrawPoint(X_Center - sCountY, Y_Center - XCurrent, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//4
-                Paint_DrawPoint(X_Center - XCurrent, Y_Center - sCountY, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//5
-                Paint_DrawPoint(X_Center + XCurrent, Y_Center - sCountY, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//6
-                Paint_DrawPoint(X_Center + sCountY, Y_Center - XCurrent, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);//7
-                Paint_DrawPoint(X_Center + sCountY, Y_Center + XCurrent, Color, DOT_PIXEL_DFT, DOT_STYLE_DFT);
-            }
+            //the 8 octant runs of sCountY = XCurrent..YCurrent as spans, 1x1 points land one up and left
+            int Xc = X_Center - 1, Yc = Y_Center - 1;
+            Paint_FillSpan(Xc + XCurrent, Yc + XCurrent, Xc + XCurrent, Yc + YCurrent, Color);//1
+            Paint_FillSpan(Xc - XCurrent, Yc + XCurrent, Xc - XCurrent, Yc + YCurrent, Color);//2
+            Paint_FillSpan(Xc - YCurrent, Yc + XCurrent, Xc - XCurrent, Yc + XCurrent, Color);//3
+            Paint_FillSpan(Xc - YCurrent, Yc - XCurrent, Xc - XCurrent, Yc - XCurrent, Color);//4
+            Paint_FillSpan(Xc - XCurrent, Yc - YCurrent, Xc - XCurrent, Yc - XCurrent, Color);//5
+            Paint_FillSpan(Xc + XCurrent, Yc - YCurrent, Xc + XCurrent, Yc - XCurrent, Color);//6
+            Paint_FillSpan(Xc + XCurrent, Yc - XCurrent, Xc + YCurrent, Yc - XCurrent, Color);//7
+            Paint_FillSpan(Xc + XCurrent, Yc + XCurrent, Xc + YCurrent, Yc + XCurrent, Color);
             if (Esp < 0 )
                 Esp += 4 * XCurrent + 6;
             else {
@@ -483,24 +707,132 @@ void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius,
             }
             XCurrent ++;
         }
-    } else { //Draw a hollow circle
-        while (XCurrent <= YCurrent ) {
-            Paint_DrawPoint(X_Center + XCurrent, Y_Center + YCurrent, Color, Line_width, DOT_STYLE_DFT);//1
-            Paint_DrawPoint(X_Center - XCurrent, Y_Center + YCurrent, Color, Line_width, DOT_STYLE_DFT);//2
-            Paint_DrawPoint(X_Center - YCurrent, Y_Center + XCurrent, Color, Line_width, DOT_STYLE_DFT);//3
-            Paint_DrawPoint(X_Center - YCurrent, Y_Center - XCurrent, Color, Line_width, DOT_STYLE_DFT);//4
-            Paint_DrawPoint(X_Center - XCurrent, Y_Center - YCurrent, Color, Line_width, DOT_STYLE_DFT);//5
-            Paint_DrawPoint(X_Center + XCurrent, Y_Center - YCurrent, Color, Line_width, DOT_STYLE_DFT);//6
-            Paint_DrawPoint(X_Center + YCurrent, Y_Center - XCurrent, Color, Line_width, DOT_STYLE_DFT);//7
-            Paint_DrawPoint(X_Center + YCurrent, Y_Center + XCurrent, Color, Line_width, DOT_STYLE_DFT);//0
+    } else if (Line_width == DOT_PIXEL_1X1) { //Draw a hollow circle
+        Paint_Writer->Circle(X_Center, Y_Center, Radius, Color);
+    } else {
+        Paint_CircleLoop(X_Center, Y_Center, Radius, [Color, Line_width](int Xpoint, int Ypoint) {
+            Paint_DrawPoint(Xpoint, Ypoint, Color, Line_width, DOT_STYLE_DFT);
+        });
+    }
+}
 
-            if (Esp < 0 )
-                Esp += 4 * XCurrent + 6;
-            else {
-                Esp += 10 + 4 * (XCurrent - YCurrent );
-                YCurrent --;
+/******************************************************************************
+function: Glyphs turned to the image memory orientation, for rotated or
+          mirrored images. A small round robin cache, a screen of text only
+          uses a handful of characters
+******************************************************************************/
+#define PAINT_GLYPH_CACHE 16
+#define PAINT_GLYPH_BYTES 72 //Font24 (17x24) in any orientation
+
+static struct {
+    const sFONT *Font;
+    char Char;
+    UBYTE Orient;
+    UBYTE Bits[PAINT_GLYPH_BYTES];
+} Paint_Glyphs[PAINT_GLYPH_CACHE];
+static UBYTE Paint_GlyphNext = 0;
+
+/******************************************************************************
+function: Turn a glyph from the font table to the memory orientation
+parameter:
+    ptr        : the glyph in the font table
+    Font       : its font
+    Acsii_Char : its character
+    Orient     : Rotate / 90 + Mirror * 4
+return:     GW / 8 rounded up bytes per row, GH rows, NULL if it does not fit the cache
+******************************************************************************/
+static const UBYTE *Paint_TurnGlyph(const unsigned char *ptr, const sFONT *Font, char Acsii_Char, UBYTE Orient)
+{
+    UWORD W = Font->Width, H = Font->Height;
+    UWORD GW = (Orient & 1) ? H : W;
+    UWORD GH = (Orient & 1) ? W : H;
+    UWORD GWByte = (GW + 7) / 8;
+    UWORD FontByte = W / 8 + (W % 8 ? 1 : 0);
+
+    for (UBYTE i = 0; i < PAINT_GLYPH_CACHE; i++) {
+        if (Paint_Glyphs[i].Font == Font && Paint_Glyphs[i].Char == Acsii_Char && Paint_Glyphs[i].Orient == Orient)
+            return Paint_Glyphs[i].Bits;
+    }
+    if (GWByte * GH > PAINT_GLYPH_BYTES)
+        return NULL;
+
+    UBYTE *Bits = Paint_Glyphs[Paint_GlyphNext].Bits;
+    Paint_Glyphs[Paint_GlyphNext].Font = Font;
+    Paint_Glyphs[Paint_GlyphNext].Char = Acsii_Char;
+    Paint_Glyphs[Paint_GlyphNext].Orient = Orient;
+    Paint_GlyphNext = (Paint_GlyphNext + 1) % PAINT_GLYPH_CACHE;
+
+    memset(Bits, 0, PAINT_GLYPH_BYTES);
+    for (UWORD r = 0; r < H; r++) {
+        for (UWORD c = 0; c < W; c++) {
+            if (!(ptr[r * FontByte + c / 8] & (0x80 >> (c % 8))))
+                continue;
+            UWORD u, v; //same turns as Paint_SetPixel
+            switch (Orient & 3) {
+            case 1:  u = H - 1 - r; v = c;         break;
+            case 2:  u = W - 1 - c; v = H - 1 - r; break;
+            case 3:  u = r;         v = W - 1 - c; break;
+            default: u = c;         v = r;         break;
+            }
+            if (Orient & (MIRROR_HORIZONTAL << 2))
+                u = GW - 1 - u;
+            if (Orient & (MIRROR_VERTICAL << 2))
+                v = GH - 1 - v;
+            Bits[v * GWByte + u / 8] |= 0x80 >> (u % 8);
+        }
+    }
+    return Bits;
+}
+
+/******************************************************************************
+function: Write a 1 bit glyph into the image a byte at a time
+parameter:
+    Glyph  : GW x GH pixels in memory orientation, rows of whole bytes
+    Mx     : memory column of the glyph's left edge, may be off the image
+    My     : memory row of its top edge
+    Color_Foreground : color of the set bits
+    Color_Background : color of the others
+    Opaque : 0 leaves the background pixels alone
+******************************************************************************/
+static void Paint_BlitGlyph(const UBYTE *Glyph, UWORD GW, UWORD GH, int Mx, int My,
+                            UWORD Color_Foreground, UWORD Color_Background, UBYTE Opaque)
+{
+    int GWByte = (GW + 7) / 8;
+    int Lo = Mx < 0 ? 0 : Mx;
+    int Hi = Mx + GW - 1 < Paint.WidthMemory - 1 ? Mx + GW - 1 : Paint.WidthMemory - 1;
+    if (Lo > Hi)
+        return;
+    UBYTE Fg = (Color_Foreground == BLACK) ? 0x00 : 0xFF;
+    UBYTE Bg = (Color_Background == BLACK) ? 0x00 : 0xFF;
+
+    for (UWORD v = 0; v < GH; v++) {
+        int Y = My + v;
+        if (Y < 0 || Y >= Paint.HeightMemory)
+            continue;
+        const UBYTE *Src = Glyph + v * GWByte;
+        UBYTE *Row = Paint.Image + (UDOUBLE)Y * Paint.WidthByte;
+        for (int B = Lo / 8; B <= Hi / 8; B++) {
+            //glyph pixels U..U+7 land on this byte, U >= -7
+            int U = B * 8 - Mx;
+            int Q = (U + 8) / 8 - 1, R = U - Q * 8;
+            UBYTE Bits = 0;
+            if (Q >= 0)
+                Bits = Src[Q] << R;
+            if (R && Q + 1 < GWByte)
+                Bits |= Src[Q + 1] >> (8 - R);
+
+            UBYTE Mask = 0xFF;
+            if (B * 8 < Lo)
+                Mask &= 0xFF >> (Lo - B * 8);
+            if (B * 8 + 7 > Hi)
+                Mask &= 0xFF << (B * 8 + 7 - Hi);
+            if (Opaque) {
+                UBYTE Pixels = (Bits & Fg) | (~Bits & Bg);
+                Row[B] = (Row[B] & ~Mask) | (Pixels & Mask);
+            } else {
+                Mask &= Bits;
+                Row[B] = (Row[B] & ~Mask) | (Fg & Mask);
             }
-            XCurrent ++;
         }
     }
 }
@@ -528,6 +860,29 @@ void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
     uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height * (Font->Width / 8 + (Font->Width % 8 ? 1 : 0));
     const unsigned char *ptr = &Font->table[Char_Offset];
 
+    //black and white images: whole glyph rows with shifts and masks, turned through the cache if needed
+    if (Paint.Scale == 2) {
+        UBYTE Orient = (Paint.Rotate / 90) % 4 + (Paint.Mirror % 4) * 4;
+        const UBYTE *Glyph = Orient ? Paint_TurnGlyph(ptr, Font, Acsii_Char, Orient) : ptr;
+        if (Glyph != NULL) {
+            int W = Font->Width, H = Font->Height;
+            int GW = (Orient & 1) ? H : W, GH = (Orient & 1) ? W : H;
+            int Mx, My; //memory position of the glyph's corner
+            switch (Orient & 3) {
+            case 1:  Mx = Paint.WidthMemory - Ypoint - H;  My = Xpoint;                          break;
+            case 2:  Mx = Paint.WidthMemory - Xpoint - W;  My = Paint.HeightMemory - Ypoint - H; break;
+            case 3:  Mx = Ypoint;                          My = Paint.HeightMemory - Xpoint - W; break;
+            default: Mx = Xpoint;                          My = Ypoint;                          break;
+            }
+            if (Paint.Mirror & MIRROR_HORIZONTAL)
+                Mx = Paint.WidthMemory - Mx - GW;
+            if (Paint.Mirror & MIRROR_VERTICAL)
+                My = Paint.HeightMemory - My - GH;
+            Paint_BlitGlyph(Glyph, GW, GH, Mx, My, Color_Foreground, Color_Background, FONT_BACKGROUND != Color_Background);
+            return;
+        }
+    }
+
     for (Page = 0; Page < Font->Height; Page ++ ) {
         for (Column = 0; Column < Font->Width; Column ++ ) {
 
@@ -814,20 +1169,7 @@ info:
 ******************************************************************************/
 void Paint_DrawBitMap_Paste(const unsigned char* image_buffer, UWORD xStart, UWORD yStart, UWORD imageWidth, UWORD imageHeight, UBYTE flipColor)
 {
-    UBYTE color, srcImage;
-    UWORD x, y;
-    UWORD width = (imageWidth%8==0 ? imageWidth/8 : imageWidth/8+1);
-    
-    for (y = 0; y < imageHeight; y++) {
-        for (x = 0; x < imageWidth; x++) {
-            srcImage = image_buffer[y*width + x/8];
-            if(flipColor)
-                color = (((srcImage<<(x%8) & 0x80) == 0) ? 1 : 0);
-            else
-                color = (((srcImage<<(x%8) & 0x80) == 0) ? 0 : 1);
-            Paint_SetPixel(x+xStart, y+yStart, color);
-        }
-    }
+    Paint_Writer->Paste(image_buffer, xStart, yStart, imageWidth, imageHeight, flipColor);
 }
 
 /******************************************************************************
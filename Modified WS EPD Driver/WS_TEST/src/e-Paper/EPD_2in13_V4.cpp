@@ -30,6 +30,28 @@
 ******************************************************************************/
 #include "EPD_2in13_V4.h"
 
+//waveform manager state, see EPD_2in13_V4_StartWaveform
+static const UBYTE *EPD_2in13_V4_LUT = NULL; //waveform in the panel, NULL after a reset or an OTP load
+static UBYTE EPD_2in13_V4_LUTScale = 0;
+static UBYTE EPD_2in13_V4_Scale = 100; //band for the current temperature
+static UWORD EPD_2in13_V4_Partials = 0; //fast updates since the last clean or full refresh
+static UBYTE EPD_2in13_V4_CleanRequest = 0;
+static int EPD_2in13_V4_Temperature = 25;
+static UBYTE EPD_2in13_V4_TemperatureSet = 0;
+
+//copy of the controller RAM, see EPD_2in13_V4_Display_Diff
+#define EPD_2in13_V4_LINE ((EPD_2in13_V4_WIDTH + 7) / 8) //bytes per RAM row
+#define EPD_2in13_V4_MAX_BANDS 8
+#define EPD_2in13_V4_BAND_GAP 2 //unchanged rows worth sending rather than opening a new window
+typedef struct {
+	UWORD Y0, Y1;
+	UBYTE X0, X1; //RAM byte columns
+} EPD_2in13_V4_BAND;
+static UBYTE EPD_2in13_V4_Shadow[EPD_2in13_V4_LINE * EPD_2in13_V4_HEIGHT]; //what 0x24 holds
+static UBYTE EPD_2in13_V4_ShadowValid = 0;
+static EPD_2in13_V4_BAND EPD_2in13_V4_Stale[EPD_2in13_V4_MAX_BANDS]; //where 0x26 may differ from the shadow
+static UBYTE EPD_2in13_V4_StaleCount = 0;
+
 
 /******************************************************************************
 function :	Software reset
@@ -43,6 +65,7 @@ static void EPD_2in13_V4_Reset(void)
     DEV_Delay_ms(2);
     DEV_Digital_Write(EPD_RST_PIN, 1);
     DEV_Delay_ms(20);
+	EPD_2in13_V4_LUT = NULL;
 }
 
 /******************************************************************************
@@ -72,22 +95,135 @@ static void EPD_2in13_V4_SendData(UBYTE Data)
 }
 
 /******************************************************************************
-function :	Wait until the busy_pin goes LOW
+function :	send a block of data with DC and CS set once
+parameter:
+    Data : Write data
+    Len  : number of bytes
+******************************************************************************/
+static void EPD_2in13_V4_SendDataBlock(UBYTE *Data, UDOUBLE Len)
+{
+    DEV_Digital_Write(EPD_DC_PIN, 1);
+    DEV_Digital_Write(EPD_CS_PIN, 0);
+    DEV_SPI_Write_nByte(Data, Len);
+    DEV_Digital_Write(EPD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	send the same byte Len times, a row at a time
+parameter:
+    Data : Write data
+    Len  : number of bytes
+******************************************************************************/
+static void EPD_2in13_V4_SendDataFill(UBYTE Data, UDOUBLE Len)
+{
+    UBYTE Row[32];
+    memset(Row, Data, sizeof(Row));
+    DEV_Digital_Write(EPD_DC_PIN, 1);
+    DEV_Digital_Write(EPD_CS_PIN, 0);
+    while (Len > 0) {
+        UDOUBLE n = (Len < sizeof(Row)) ? Len : sizeof(Row);
+        DEV_SPI_Write_nByte(Row, n);
+        Len -= n;
+    }
+    DEV_Digital_Write(EPD_CS_PIN, 1);
+}
+
+/******************************************************************************
+function :	Finish an update: record its time and call the done callback, once
+parameter:
+******************************************************************************/
+static volatile UBYTE EPD_2in13_V4_Updating = 0;
+static volatile UBYTE EPD_2in13_V4_BusySeen = 0; //BUSY has been high since the update started
+static void (*EPD_2in13_V4_Done)(void) = NULL;
+static UDOUBLE EPD_2in13_V4_UpdateStart = 0;
+static UBYTE EPD_2in13_V4_UpdateMode = 0; //0x22 value of the update, the callback is only for ones that drive the glass
+static volatile UDOUBLE EPD_2in13_V4_UpdateMs = 0;
+
+static void EPD_2in13_V4_Finish(void)
+{
+	noInterrupts(); //the BUSY interrupt and a waiting caller may both get here
+	UBYTE Updating = EPD_2in13_V4_Updating;
+	EPD_2in13_V4_Updating = 0;
+	interrupts();
+	if(!Updating)
+		return; //reset and init pulses, or already finished
+	if(!(EPD_2in13_V4_UpdateMode & 0x04))
+		return; //temperature and LUT loads
+	EPD_2in13_V4_UpdateMs = millis() - EPD_2in13_V4_UpdateStart;
+	if(EPD_2in13_V4_Done != NULL)
+		EPD_2in13_V4_Done();
+}
+
+/******************************************************************************
+function :	BUSY falling edge, the panel has finished an update
+parameter:
+******************************************************************************/
+static void EPD_2in13_V4_BusyISR(void)
+{
+	EPD_2in13_V4_Finish();
+}
+
+/******************************************************************************
+function :	Check whether an update started by an _Async function is still running
+parameter:
+******************************************************************************/
+UBYTE EPD_2in13_V4_IsBusy(void)
+{
+	if(!EPD_2in13_V4_Updating)
+		return 0;
+	if(DEV_Digital_Read(EPD_BUSY_PIN) == 1) {
+		EPD_2in13_V4_BusySeen = 1;
+		return 1;
+	}
+	//BUSY low: the edge was missed (interrupts off) only if BUSY was seen high, or the update has
+	//run longer than BUSY takes to rise. Otherwise the panel has not started it yet
+	if(EPD_2in13_V4_BusySeen || millis() - EPD_2in13_V4_UpdateStart >= EPD_2in13_V4_BUSY_RISE_MS)
+		EPD_2in13_V4_Finish();
+	return EPD_2in13_V4_Updating;
+}
+
+/******************************************************************************
+function :	Wait until the panel is idle: the update started last has finished
+			and the busy_pin is LOW
 parameter:
 ******************************************************************************/
 void EPD_2in13_V4_ReadBusy(void)
 {
     Debug("e-Paper busy\r\n");
-	while(1)
-	{	 //=1 BUSY
-		if(DEV_Digital_Read(EPD_BUSY_PIN)==0) 
-			break;
-		DEV_Delay_ms(10);
+	//=1 BUSY. During an update IsBusy() also covers the time before BUSY rises and finishes it
+	while(EPD_2in13_V4_IsBusy() || DEV_Digital_Read(EPD_BUSY_PIN) == 1)
+	{
+		DEV_Delay_ms(1); //at most 1ms late, rather than 10-20ms
 	}
-	DEV_Delay_ms(10);
     Debug("e-Paper busy release\r\n");
 }
 
+/******************************************************************************
+function :	Wait for a command that raises BUSY outside an update (SWRESET): BUSY
+			may still be low right after it, so it gets EPD_2in13_V4_BUSY_RISE_MS
+			to rise before the wait for it to fall
+parameter:
+******************************************************************************/
+static void EPD_2in13_V4_ReadBusyAfter(void)
+{
+	UDOUBLE Start = millis();
+	while(DEV_Digital_Read(EPD_BUSY_PIN) == 0 && millis() - Start < EPD_2in13_V4_BUSY_RISE_MS)
+	{
+		delayMicroseconds(10);
+	}
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	Set the function called (usually from the BUSY interrupt) when an update finishes
+parameter:
+	Callback : function to call, NULL for none
+******************************************************************************/
+void EPD_2in13_V4_SetDoneCallback(void (*Callback)(void))
+{
+	EPD_2in13_V4_Done = Callback;
+}
+
 /******************************************************************************
 function :	Setting the display window
 parameter:
@@ -126,30 +262,222 @@ static void EPD_2in13_V4_SetCursor(UWORD Xstart, UWORD Ystart)
 }
 
 /******************************************************************************
-function :	Turn On Display
+function :	Write a block of rows of the image buffer to one RAM, leaving the
+			RAM window on the block
 parameter:
+	Reg    : 0x24 (black/white) or 0x26 (previous image)
+	Xbyte0 : first RAM byte column
+	Xbyte1 : last RAM byte column
+	Y0     : first row
+	Y1     : last row
+	Image  : whole image data, the block is read out of it
 ******************************************************************************/
-static void EPD_2in13_V4_TurnOnDisplay(void)
+static void EPD_2in13_V4_WriteRAM(UBYTE Reg, UWORD Xbyte0, UWORD Xbyte1, UWORD Y0, UWORD Y1, UBYTE *Image)
 {
-	EPD_2in13_V4_SendCommand(0x22); // Display Update Control
-	EPD_2in13_V4_SendData(0xf7);
-	EPD_2in13_V4_SendCommand(0x20); // Activate Display Update Sequence
-	EPD_2in13_V4_ReadBusy();
+	UWORD Bytes = Xbyte1 - Xbyte0 + 1;
+
+	EPD_2in13_V4_SetWindows(Xbyte0 << 3, Y0, Xbyte1 << 3, Y1);
+	EPD_2in13_V4_SetCursor(Xbyte0, Y0); //the X counter is a byte address
+
+	EPD_2in13_V4_SendCommand(Reg);
+	DEV_Digital_Write(EPD_DC_PIN, 1);
+	DEV_Digital_Write(EPD_CS_PIN, 0);
+	for (UWORD j = Y0; j <= Y1; j++) {
+		DEV_SPI_Write_nByte(Image + j * EPD_2in13_V4_LINE + Xbyte0, Bytes);
+	}
+	DEV_Digital_Write(EPD_CS_PIN, 1);
 }
 
-static void EPD_2in13_V4_TurnOnDisplay_Fast(void)
+/******************************************************************************
+function :	Note that 0x26 may no longer match the shadow in a block
+parameter:
+	Xbyte0 : first RAM byte column
+	Xbyte1 : last RAM byte column
+	Y0     : first row
+	Y1     : last row
+******************************************************************************/
+static void EPD_2in13_V4_AddStale(UWORD Xbyte0, UWORD Xbyte1, UWORD Y0, UWORD Y1)
+{
+	if(EPD_2in13_V4_StaleCount < EPD_2in13_V4_MAX_BANDS) {
+		EPD_2in13_V4_BAND *Band = &EPD_2in13_V4_Stale[EPD_2in13_V4_StaleCount++];
+		Band->Y0 = Y0;
+		Band->Y1 = Y1;
+		Band->X0 = Xbyte0;
+		Band->X1 = Xbyte1;
+		return;
+	}
+	//out of slots, grow the last one over it
+	EPD_2in13_V4_BAND *Band = &EPD_2in13_V4_Stale[EPD_2in13_V4_MAX_BANDS - 1];
+	if(Y0 < Band->Y0) Band->Y0 = Y0;
+	if(Y1 > Band->Y1) Band->Y1 = Y1;
+	if(Xbyte0 < Band->X0) Band->X0 = Xbyte0;
+	if(Xbyte1 > Band->X1) Band->X1 = Xbyte1;
+}
+
+/******************************************************************************
+function :	Record a block written to 0x24 only: the shadow takes the new rows,
+			0x26 keeps whatever the update leaves in it
+parameter:
+	Xbyte0 : first RAM byte column
+	Xbyte1 : last RAM byte column
+	Y0     : first row
+	Y1     : last row
+	Image  : whole image data, the block is read out of it
+******************************************************************************/
+static void EPD_2in13_V4_Track(UWORD Xbyte0, UWORD Xbyte1, UWORD Y0, UWORD Y1, UBYTE *Image)
+{
+	if(Xbyte0 == 0 && Xbyte1 == EPD_2in13_V4_LINE - 1 && Y0 == 0 && Y1 == EPD_2in13_V4_HEIGHT - 1) {
+		EPD_2in13_V4_ShadowValid = 1; //the whole RAM is known again
+		EPD_2in13_V4_StaleCount = 0;
+	}
+	if(!EPD_2in13_V4_ShadowValid)
+		return;
+	for (UWORD j = Y0; j <= Y1; j++) {
+		memcpy(EPD_2in13_V4_Shadow + j * EPD_2in13_V4_LINE + Xbyte0, Image + j * EPD_2in13_V4_LINE + Xbyte0, Xbyte1 - Xbyte0 + 1);
+	}
+	EPD_2in13_V4_AddStale(Xbyte0, Xbyte1, Y0, Y1);
+}
+
+/******************************************************************************
+Waveforms loaded by the host, 153 bytes for register 0x32 followed by
+EOPT (0x3F), gate voltage (0x03), source voltages (0x04) and VCOM (0x2C).
+Rows are LUT0..LUT4 (old/new pixel: BB, BW, WB, WW, VCOM), 2 bits per phase:
+00 VSS, 01 VSH1 (to black), 10 VSL (to white), 11 VSH2
+******************************************************************************/
+//fast monochrome partial: one 20 frame push of the changed pixels, one frame touch-up
+static const UBYTE EPD_2in13_V4_WF_Fast[159] = {
+	0x00,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x80,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x40,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x14,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x01,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x01,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x22,0x22,0x22,0x22,0x22,0x22,0x00,0x00,0x00,
+	0x22,0x17,0x41,0x00,0x32,0x36,
+};
+
+//ghost clearing: every pixel is shaken white/black four times, then driven to its new colour
+static const UBYTE EPD_2in13_V4_WF_Clean[159] = {
+	0x99,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x66,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x99,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x66,0x80,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x0A,0x0A,0x00,0x0A,0x0A,0x00,0x01,
+	0x14,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x22,0x22,0x22,0x22,0x22,0x22,0x00,0x00,0x00,
+	0x22,0x17,0x41,0x00,0x32,0x36,
+};
+
+//the waveforms are tuned for room temperature, colder panels need longer pushes
+static const struct {
+	int Below; //degrees C
+	UBYTE Scale; //frame counts in %, 0: use the OTP full refresh instead
+} EPD_2in13_V4_Bands[] = {
+	{5, 0},
+	{15, 150},
+	{30, 100},
+	{127, 70},
+};
+
+/******************************************************************************
+function :	Load a waveform into the panel
+parameter:
+	Lut   : one of the EPD_2in13_V4_WF_ tables
+	Scale : frame counts in %
+******************************************************************************/
+static void EPD_2in13_V4_LoadLUT(const UBYTE *Lut, UBYTE Scale)
+{
+	UBYTE Buf[153];
+	memcpy(Buf, Lut, sizeof(Buf));
+	for (UBYTE g = 0; g < 12; g++) { //12 groups of TPA TPB SRAB TPC TPD SRCD RP after the 60 voltage bytes
+		static const UBYTE Tp[4] = {0, 1, 3, 4};
+		for (UBYTE k = 0; k < 4; k++) {
+			UBYTE *t = &Buf[60 + g * 7 + Tp[k]];
+			if(*t == 0)
+				continue;
+			UWORD v = (*t * Scale + 50) / 100;
+			*t = (v < 1)? 1 : (v > 255)? 255 : v;
+		}
+	}
+
+	EPD_2in13_V4_SendCommand(0x32); //Write LUT register
+	EPD_2in13_V4_SendDataBlock(Buf, sizeof(Buf));
+	EPD_2in13_V4_SendCommand(0x3F); //End option
+	EPD_2in13_V4_SendData(Lut[153]);
+	EPD_2in13_V4_SendCommand(0x03); //Gate driving voltage
+	EPD_2in13_V4_SendData(Lut[154]);
+	EPD_2in13_V4_SendCommand(0x04); //Source driving voltage
+	EPD_2in13_V4_SendData(Lut[155]);
+	EPD_2in13_V4_SendData(Lut[156]);
+	EPD_2in13_V4_SendData(Lut[157]);
+	EPD_2in13_V4_SendCommand(0x2C); //VCOM
+	EPD_2in13_V4_SendData(Lut[158]);
+	EPD_2in13_V4_SendCommand(0x3C); //BorderWavefrom, border left alone
+	EPD_2in13_V4_SendData(0x80);
+
+	EPD_2in13_V4_LUT = Lut;
+	EPD_2in13_V4_LUTScale = Scale;
+}
+
+/******************************************************************************
+function :	Start an update sequence and return without waiting for it. The
+			update is armed before the activation command, so IsBusy() and
+			ReadBusy() cover it from then on, including the time before BUSY
+			rises; the done callback runs when one that drives the glass ends
+parameter:
+	Mode : Display Update Control 2 value (0xf7 full, 0xc7 fast, 0xff partial,
+	       0xb1/0x91 temperature loads)
+******************************************************************************/
+static void EPD_2in13_V4_StartUpdate(UBYTE Mode)
 {
 	EPD_2in13_V4_SendCommand(0x22); // Display Update Control
-	EPD_2in13_V4_SendData(0xc7);	// fast:0x0c, quality:0x0f, 0xcf
+	EPD_2in13_V4_SendData(Mode);
+	if(Mode & 0x10)
+		EPD_2in13_V4_LUT = NULL; //loaded from OTP over ours
+	if(Mode == 0xf7)
+		EPD_2in13_V4_Partials = 0; //a full refresh clears the ghosting too
+	EPD_2in13_V4_UpdateStart = millis();
+	EPD_2in13_V4_UpdateMode = Mode;
+	EPD_2in13_V4_BusySeen = 0;
+	EPD_2in13_V4_Updating = 1; //armed before BUSY rises, cleared on its falling edge
 	EPD_2in13_V4_SendCommand(0x20); // Activate Display Update Sequence
+}
+
+/******************************************************************************
+function :	Turn On Display
+parameter:
+******************************************************************************/
+static void EPD_2in13_V4_TurnOnDisplay(void)
+{
+	EPD_2in13_V4_StartUpdate(0xf7);
 	EPD_2in13_V4_ReadBusy();
 }
 
-static void EPD_2in13_V4_TurnOnDisplay_Partial(void)
+static void EPD_2in13_V4_TurnOnDisplay_Fast(void)
 {
-	EPD_2in13_V4_SendCommand(0x22); // Display Update Control
-	EPD_2in13_V4_SendData(0xff);	// fast:0x0c, quality:0x0f, 0xcf
-	EPD_2in13_V4_SendCommand(0x20); // Activate Display Update Sequence
+	EPD_2in13_V4_StartUpdate(0xc7);	// fast:0x0c, quality:0x0f, 0xcf
 	EPD_2in13_V4_ReadBusy();
 }
 
@@ -160,10 +488,12 @@ parameter:
 void EPD_2in13_V4_Init(void)
 {
 	EPD_2in13_V4_Reset();
+	attachInterrupt(digitalPinToInterrupt(EPD_BUSY_PIN), EPD_2in13_V4_BusyISR, FALLING);
+	EPD_2in13_V4_ShadowValid = 0; //RAM contents unknown until a whole image is written
 
 	EPD_2in13_V4_ReadBusy();  
 	EPD_2in13_V4_SendCommand(0x12);  //SWRESET
-	EPD_2in13_V4_ReadBusy();   
+	EPD_2in13_V4_ReadBusyAfter();
 		
 	EPD_2in13_V4_SendCommand(0x01); //Driver output control      
 	EPD_2in13_V4_SendData(0xF9);
@@ -191,9 +521,11 @@ void EPD_2in13_V4_Init(void)
 void EPD_2in13_V4_Init_Fast(void)
 {
 	EPD_2in13_V4_Reset();
+	attachInterrupt(digitalPinToInterrupt(EPD_BUSY_PIN), EPD_2in13_V4_BusyISR, FALLING);
+	EPD_2in13_V4_ShadowValid = 0; //RAM contents unknown until a whole image is written
 
 	EPD_2in13_V4_SendCommand(0x12);  //SWRESET
-	EPD_2in13_V4_ReadBusy();   
+	EPD_2in13_V4_ReadBusyAfter();
 
 	EPD_2in13_V4_SendCommand(0x18); //Read built-in temperature sensor
 	EPD_2in13_V4_SendData(0x80);
@@ -204,18 +536,14 @@ void EPD_2in13_V4_Init_Fast(void)
 	EPD_2in13_V4_SetWindows(0, 0, EPD_2in13_V4_WIDTH-1, EPD_2in13_V4_HEIGHT-1);
 	EPD_2in13_V4_SetCursor(0, 0);	
 		
-	EPD_2in13_V4_SendCommand(0x22); // Load temperature value
-	EPD_2in13_V4_SendData(0xB1);		
-	EPD_2in13_V4_SendCommand(0x20);	
+	EPD_2in13_V4_StartUpdate(0xB1); // Load temperature value
 	EPD_2in13_V4_ReadBusy();   
 
 	EPD_2in13_V4_SendCommand(0x1A); // Write to temperature register
 	EPD_2in13_V4_SendData(0x64);		
 	EPD_2in13_V4_SendData(0x00);	
 					
-	EPD_2in13_V4_SendCommand(0x22); // Load temperature value
-	EPD_2in13_V4_SendData(0x91);		
-	EPD_2in13_V4_SendCommand(0x20);	
+	EPD_2in13_V4_StartUpdate(0x91); // Load temperature value
 	EPD_2in13_V4_ReadBusy();   
 }
 
@@ -229,12 +557,13 @@ void EPD_2in13_V4_Clear(void)
     Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
     Height = EPD_2in13_V4_HEIGHT;
 	
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
     EPD_2in13_V4_SendCommand(0x24);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_2in13_V4_SendData(0XFF);
-        }
-    }	
+    EPD_2in13_V4_SendDataFill(0XFF, Width * Height);
+	memset(EPD_2in13_V4_Shadow, 0XFF, sizeof(EPD_2in13_V4_Shadow));
+	EPD_2in13_V4_ShadowValid = 1;
+	EPD_2in13_V4_StaleCount = 0;
+	EPD_2in13_V4_AddStale(0, EPD_2in13_V4_LINE - 1, 0, EPD_2in13_V4_HEIGHT - 1); //0x26 not written
 
 	EPD_2in13_V4_TurnOnDisplay();
 }
@@ -245,12 +574,13 @@ void EPD_2in13_V4_Clear_Black(void)
     Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
     Height = EPD_2in13_V4_HEIGHT;
 	
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
     EPD_2in13_V4_SendCommand(0x24);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_2in13_V4_SendData(0X00);
-        }
-    }	
+    EPD_2in13_V4_SendDataFill(0X00, Width * Height);
+	memset(EPD_2in13_V4_Shadow, 0X00, sizeof(EPD_2in13_V4_Shadow));
+	EPD_2in13_V4_ShadowValid = 1;
+	EPD_2in13_V4_StaleCount = 0;
+	EPD_2in13_V4_AddStale(0, EPD_2in13_V4_LINE - 1, 0, EPD_2in13_V4_HEIGHT - 1); //0x26 not written
 
 	EPD_2in13_V4_TurnOnDisplay();
 }
@@ -261,19 +591,29 @@ parameter:
 	Image : Image data
 ******************************************************************************/
 void EPD_2in13_V4_Display(UBYTE *Image)
+{
+	EPD_2in13_V4_Display_Async(Image);
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display, but returns as soon as the update has started.
+			Poll EPD_2in13_V4_IsBusy() or use EPD_2in13_V4_SetDoneCallback() for the end
+parameter:
+	Image : Image data
+******************************************************************************/
+void EPD_2in13_V4_Display_Async(UBYTE *Image)
 {
 	UWORD Width, Height;
     Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
     Height = EPD_2in13_V4_HEIGHT;
 	
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
     EPD_2in13_V4_SendCommand(0x24);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_2in13_V4_SendData(Image[i + j * Width]);
-        }
-    }	
+    EPD_2in13_V4_SendDataBlock(Image, Width * Height);
+	EPD_2in13_V4_Track(0, EPD_2in13_V4_LINE - 1, 0, EPD_2in13_V4_HEIGHT - 1, Image);
 	
-	EPD_2in13_V4_TurnOnDisplay();	
+	EPD_2in13_V4_StartUpdate(0xf7);
 }
 
 void EPD_2in13_V4_Display_Fast(UBYTE *Image)
@@ -282,12 +622,10 @@ void EPD_2in13_V4_Display_Fast(UBYTE *Image)
     Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
     Height = EPD_2in13_V4_HEIGHT;
 	
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
     EPD_2in13_V4_SendCommand(0x24);
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-            EPD_2in13_V4_SendData(Image[i + j * Width]);
-        }
-    }	
+    EPD_2in13_V4_SendDataBlock(Image, Width * Height);
+	EPD_2in13_V4_Track(0, EPD_2in13_V4_LINE - 1, 0, EPD_2in13_V4_HEIGHT - 1, Image);
 	
 	EPD_2in13_V4_TurnOnDisplay_Fast();	
 }
@@ -304,18 +642,14 @@ void EPD_2in13_V4_Display_Base(UBYTE *Image)
     Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
     Height = EPD_2in13_V4_HEIGHT;
 	
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
 	EPD_2in13_V4_SendCommand(0x24);   //Write Black and White image to RAM
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {        
-			EPD_2in13_V4_SendData(Image[i + j * Width]);
-		}
-	}
+	EPD_2in13_V4_SendDataBlock(Image, Width * Height);
 	EPD_2in13_V4_SendCommand(0x26);   //Write Black and White image to RAM
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-			EPD_2in13_V4_SendData(Image[i + j * Width]);
-		}
-	}
+	EPD_2in13_V4_SendDataBlock(Image, Width * Height);
+	memcpy(EPD_2in13_V4_Shadow, Image, sizeof(EPD_2in13_V4_Shadow));
+	EPD_2in13_V4_ShadowValid = 1;
+	EPD_2in13_V4_StaleCount = 0; //both RAMs hold the image
 	EPD_2in13_V4_TurnOnDisplay();	
 }
 
@@ -325,15 +659,29 @@ parameter:
 	Image : Image data
 ******************************************************************************/
 void EPD_2in13_V4_Display_Partial(UBYTE *Image)
+{
+	EPD_2in13_V4_Display_Partial_Async(Image);
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display_Partial, but returns as soon as the update has started
+parameter:
+	Image : Image data
+******************************************************************************/
+void EPD_2in13_V4_Display_Partial_Async(UBYTE *Image)
 {
 	UWORD Width, Height;
     Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
     Height = EPD_2in13_V4_HEIGHT;
 	
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
+
 	//Reset
     DEV_Digital_Write(EPD_RST_PIN, 0);
     DEV_Delay_ms(1);
     DEV_Digital_Write(EPD_RST_PIN, 1);
+	EPD_2in13_V4_LUT = NULL;
 
 	EPD_2in13_V4_SendCommand(0x3C); //BorderWavefrom
 	EPD_2in13_V4_SendData(0x80);	
@@ -350,12 +698,353 @@ void EPD_2in13_V4_Display_Partial(UBYTE *Image)
 	EPD_2in13_V4_SetCursor(0, 0);
 
 	EPD_2in13_V4_SendCommand(0x24);   //Write Black and White image to RAM
-    for (UWORD j = 0; j < Height; j++) {
-        for (UWORD i = 0; i < Width; i++) {
-			EPD_2in13_V4_SendData(Image[i + j * Width]);
+	EPD_2in13_V4_SendDataBlock(Image, Width * Height);
+	EPD_2in13_V4_Track(0, EPD_2in13_V4_LINE - 1, 0, EPD_2in13_V4_HEIGHT - 1, Image);
+	EPD_2in13_V4_StartUpdate(0xff);
+}
+
+/******************************************************************************
+function :	Map a point of the selected Paint image to panel RAM,
+			with the same rotation and mirroring as Paint_SetPixel
+parameter:
+	Xpoint : X in Paint coordinates, replaced by the RAM column
+	Ypoint : Y in Paint coordinates, replaced by the RAM row
+******************************************************************************/
+static void EPD_2in13_V4_MapPoint(UWORD *Xpoint, UWORD *Ypoint)
+{
+	UWORD X = *Xpoint, Y = *Ypoint;
+	switch(Paint.Rotate) {
+	case 90:
+		X = EPD_2in13_V4_WIDTH - *Ypoint - 1;
+		Y = *Xpoint;
+		break;
+	case 180:
+		X = EPD_2in13_V4_WIDTH - *Xpoint - 1;
+		Y = EPD_2in13_V4_HEIGHT - *Ypoint - 1;
+		break;
+	case 270:
+		X = *Ypoint;
+		Y = EPD_2in13_V4_HEIGHT - *Xpoint - 1;
+		break;
+	default:
+		break;
+	}
+	if(Paint.Mirror == MIRROR_HORIZONTAL || Paint.Mirror == MIRROR_ORIGIN)
+		X = EPD_2in13_V4_WIDTH - X - 1;
+	if(Paint.Mirror == MIRROR_VERTICAL || Paint.Mirror == MIRROR_ORIGIN)
+		Y = EPD_2in13_V4_HEIGHT - Y - 1;
+	*Xpoint = X;
+	*Ypoint = Y;
+}
+
+/******************************************************************************
+function :	Write one rectangle of the image buffer to the black/white RAM
+parameter:
+	Xstart : X of the rectangle, in the coordinates of the selected Paint image
+	Ystart : Y of the rectangle
+	Width  : width of the rectangle
+	Height : height of the rectangle
+	Image  : whole image data, the rectangle is read out of it
+return   :	0 if the rectangle is off the panel and nothing was written
+******************************************************************************/
+static UBYTE EPD_2in13_V4_WriteWindow(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image)
+{
+	//opposite corners in RAM, rotation can swap or reverse either axis
+	UWORD X0 = Xstart, Y0 = Ystart;
+	UWORD X1 = Xstart + Width - 1, Y1 = Ystart + Height - 1;
+	EPD_2in13_V4_MapPoint(&X0, &Y0);
+	EPD_2in13_V4_MapPoint(&X1, &Y1);
+	if(X0 > X1) { UWORD t = X0; X0 = X1; X1 = t; }
+	if(Y0 > Y1) { UWORD t = Y0; Y0 = Y1; Y1 = t; }
+	if(X0 >= EPD_2in13_V4_WIDTH || Y0 >= EPD_2in13_V4_HEIGHT) {
+		Debug("Exceeding display boundaries\r\n");
+		return 0;
+	}
+	if(X1 >= EPD_2in13_V4_WIDTH)
+		X1 = EPD_2in13_V4_WIDTH - 1;
+	if(Y1 >= EPD_2in13_V4_HEIGHT)
+		Y1 = EPD_2in13_V4_HEIGHT - 1;
+
+	//RAM is written a byte (8 pixels along X) at a time
+	EPD_2in13_V4_WriteRAM(0x24, X0 >> 3, X1 >> 3, Y0, Y1, Image);   //Write Black and White image to RAM
+	EPD_2in13_V4_Track(X0 >> 3, X1 >> 3, Y0, Y1, Image);
+
+	//back to the whole panel for the full image functions
+	EPD_2in13_V4_SetWindows(0, 0, EPD_2in13_V4_WIDTH-1, EPD_2in13_V4_HEIGHT-1);
+	EPD_2in13_V4_SetCursor(0, 0);
+	return 1;
+}
+
+/******************************************************************************
+function :	Sends only a rectangle of the image buffer to e-Paper and partial refresh
+parameter:
+	Xstart : X of the rectangle, in the coordinates of the selected Paint image
+	Ystart : Y of the rectangle
+	Width  : width of the rectangle
+	Height : height of the rectangle
+	Image  : whole image data, the rectangle is read out of it
+******************************************************************************/
+void EPD_2in13_V4_Display_PartialWindow(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image)
+{
+	EPD_2in13_V4_Display_PartialWindow_Async(Xstart, Ystart, Width, Height, Image);
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display_PartialWindow, but returns as soon as the update has started
+parameter:
+	Xstart : X of the rectangle, in the coordinates of the selected Paint image
+	Ystart : Y of the rectangle
+	Width  : width of the rectangle
+	Height : height of the rectangle
+	Image  : whole image data, the rectangle is read out of it
+******************************************************************************/
+void EPD_2in13_V4_Display_PartialWindow_Async(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image)
+{
+	if(Width == 0 || Height == 0)
+		return;
+
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
+
+	//Reset
+	DEV_Digital_Write(EPD_RST_PIN, 0);
+	DEV_Delay_ms(1);
+	DEV_Digital_Write(EPD_RST_PIN, 1);
+	EPD_2in13_V4_LUT = NULL;
+
+	EPD_2in13_V4_SendCommand(0x3C); //BorderWavefrom
+	EPD_2in13_V4_SendData(0x80);
+
+	EPD_2in13_V4_SendCommand(0x01); //Driver output control
+	EPD_2in13_V4_SendData(0xF9);
+	EPD_2in13_V4_SendData(0x00);
+	EPD_2in13_V4_SendData(0x00);
+
+	EPD_2in13_V4_SendCommand(0x11); //data entry mode
+	EPD_2in13_V4_SendData(0x03);
+
+	if(EPD_2in13_V4_WriteWindow(Xstart, Ystart, Width, Height, Image))
+		EPD_2in13_V4_StartUpdate(0xff);
+}
+
+/******************************************************************************
+function :	Partial refresh that only sends what differs from the last image
+parameter:
+	Image : Image data
+******************************************************************************/
+void EPD_2in13_V4_Display_Diff(UBYTE *Image)
+{
+	EPD_2in13_V4_Display_Diff_Async(Image);
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display_Diff, but returns as soon as the update has started.
+			An image identical to the last one sends nothing and starts no update
+parameter:
+	Image : Image data
+******************************************************************************/
+void EPD_2in13_V4_Display_Diff_Async(UBYTE *Image)
+{
+	if(!EPD_2in13_V4_ShadowValid) { //nothing to compare against yet
+		EPD_2in13_V4_Display_Partial_Async(Image);
+		return;
+	}
+
+	//rows that changed, grouped into bands with the changed byte columns of their rows
+	EPD_2in13_V4_BAND Bands[EPD_2in13_V4_MAX_BANDS];
+	UBYTE Count = 0;
+	for (UWORD j = 0; j < EPD_2in13_V4_HEIGHT; j++) {
+		UBYTE *New = Image + j * EPD_2in13_V4_LINE;
+		UBYTE *Old = EPD_2in13_V4_Shadow + j * EPD_2in13_V4_LINE;
+		UBYTE X0 = 0, X1 = EPD_2in13_V4_LINE - 1;
+		while(X0 < EPD_2in13_V4_LINE && New[X0] == Old[X0])
+			X0++;
+		if(X0 == EPD_2in13_V4_LINE)
+			continue;
+		while(New[X1] == Old[X1])
+			X1--;
+
+		EPD_2in13_V4_BAND *Band = (Count > 0) ? &Bands[Count - 1] : NULL;
+		if(Band != NULL && (j - Band->Y1 <= EPD_2in13_V4_BAND_GAP || Count == EPD_2in13_V4_MAX_BANDS)) {
+			Band->Y1 = j;
+			if(X0 < Band->X0) Band->X0 = X0;
+			if(X1 > Band->X1) Band->X1 = X1;
+		} else {
+			Band = &Bands[Count++];
+			Band->Y0 = Band->Y1 = j;
+			Band->X0 = X0;
+			Band->X1 = X1;
 		}
 	}
-	EPD_2in13_V4_TurnOnDisplay_Partial();
+	if(Count == 0)
+		return;
+
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
+
+	//Reset
+	DEV_Digital_Write(EPD_RST_PIN, 0);
+	DEV_Delay_ms(1);
+	DEV_Digital_Write(EPD_RST_PIN, 1);
+	EPD_2in13_V4_LUT = NULL;
+
+	EPD_2in13_V4_SendCommand(0x3C); //BorderWavefrom
+	EPD_2in13_V4_SendData(0x80);
+
+	EPD_2in13_V4_SendCommand(0x01); //Driver output control
+	EPD_2in13_V4_SendData(0xF9);
+	EPD_2in13_V4_SendData(0x00);
+	EPD_2in13_V4_SendData(0x00);
+
+	EPD_2in13_V4_SendCommand(0x11); //data entry mode
+	EPD_2in13_V4_SendData(0x03);
+
+	//the update compares 0x24 against 0x26, so 0x26 must hold the image on the panel:
+	//refresh it where earlier updates left it behind, the rest already matches the shadow
+	for (UBYTE i = 0; i < EPD_2in13_V4_StaleCount; i++) {
+		EPD_2in13_V4_BAND *Band = &EPD_2in13_V4_Stale[i];
+		EPD_2in13_V4_WriteRAM(0x26, Band->X0, Band->X1, Band->Y0, Band->Y1, EPD_2in13_V4_Shadow);
+	}
+	EPD_2in13_V4_StaleCount = 0;
+
+	for (UBYTE i = 0; i < Count; i++) {
+		EPD_2in13_V4_BAND *Band = &Bands[i];
+		EPD_2in13_V4_WriteRAM(0x24, Band->X0, Band->X1, Band->Y0, Band->Y1, Image);
+		EPD_2in13_V4_Track(Band->X0, Band->X1, Band->Y0, Band->Y1, Image);
+	}
+
+	EPD_2in13_V4_SetWindows(0, 0, EPD_2in13_V4_WIDTH-1, EPD_2in13_V4_HEIGHT-1);
+	EPD_2in13_V4_SetCursor(0, 0);
+	EPD_2in13_V4_StartUpdate(0xff);
+}
+
+/******************************************************************************
+function :	Pick the waveform for the next update, load it if it is not in the
+			panel already and start the update
+parameter:
+******************************************************************************/
+static void EPD_2in13_V4_StartWaveform(void)
+{
+	if(EPD_2in13_V4_LUT == NULL || EPD_2in13_V4_Partials == 0) { //temperature moves slowly, check it now and then
+		int Temperature = EPD_2in13_V4_TemperatureSet ? EPD_2in13_V4_Temperature : DEV_Read_Temperature();
+		UBYTE i = 0;
+		while(i < sizeof(EPD_2in13_V4_Bands) / sizeof(EPD_2in13_V4_Bands[0]) - 1 && Temperature >= EPD_2in13_V4_Bands[i].Below)
+			i++;
+		EPD_2in13_V4_Scale = EPD_2in13_V4_Bands[i].Scale;
+	}
+	if(EPD_2in13_V4_Scale == 0) { //too cold for the short waveforms
+		EPD_2in13_V4_StartUpdate(0xf7);
+		return;
+	}
+
+	const UBYTE *Lut = EPD_2in13_V4_WF_Fast;
+	if(EPD_2in13_V4_CleanRequest || EPD_2in13_V4_Partials >= EPD_2in13_V4_CLEAN_EVERY) {
+		Lut = EPD_2in13_V4_WF_Clean;
+		EPD_2in13_V4_CleanRequest = 0;
+		EPD_2in13_V4_Partials = 0;
+	} else {
+		EPD_2in13_V4_Partials++;
+	}
+	if(Lut != EPD_2in13_V4_LUT || EPD_2in13_V4_Scale != EPD_2in13_V4_LUTScale)
+		EPD_2in13_V4_LoadLUT(Lut, EPD_2in13_V4_Scale);
+	EPD_2in13_V4_StartUpdate(0xcf); //display mode 2 with the LUT in the register, nothing loaded from OTP
+}
+
+/******************************************************************************
+function :	Sends the image buffer to e-Paper and updates it with the loaded waveforms
+parameter:
+	Image : Image data
+******************************************************************************/
+void EPD_2in13_V4_Display_Waveform(UBYTE *Image)
+{
+	EPD_2in13_V4_Display_Waveform_Async(Image);
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display_Waveform, but returns as soon as the update has started
+parameter:
+	Image : Image data
+******************************************************************************/
+void EPD_2in13_V4_Display_Waveform_Async(UBYTE *Image)
+{
+	UWORD Width, Height;
+	Width = (EPD_2in13_V4_WIDTH % 8 == 0)? (EPD_2in13_V4_WIDTH / 8 ): (EPD_2in13_V4_WIDTH / 8 + 1);
+	Height = EPD_2in13_V4_HEIGHT;
+
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
+
+	EPD_2in13_V4_SetWindows(0, 0, EPD_2in13_V4_WIDTH-1, EPD_2in13_V4_HEIGHT-1);
+	EPD_2in13_V4_SetCursor(0, 0);
+
+	EPD_2in13_V4_SendCommand(0x24);   //Write Black and White image to RAM
+	EPD_2in13_V4_SendDataBlock(Image, Width * Height);
+	EPD_2in13_V4_Track(0, EPD_2in13_V4_LINE - 1, 0, EPD_2in13_V4_HEIGHT - 1, Image);
+	EPD_2in13_V4_StartWaveform();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display_Waveform, but only sends one rectangle
+parameter:
+	Xstart : X of the rectangle, in the coordinates of the selected Paint image
+	Ystart : Y of the rectangle
+	Width  : width of the rectangle
+	Height : height of the rectangle
+	Image  : whole image data, the rectangle is read out of it
+******************************************************************************/
+void EPD_2in13_V4_Display_WaveformWindow(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image)
+{
+	EPD_2in13_V4_Display_WaveformWindow_Async(Xstart, Ystart, Width, Height, Image);
+	EPD_2in13_V4_ReadBusy();
+}
+
+/******************************************************************************
+function :	As EPD_2in13_V4_Display_WaveformWindow, but returns as soon as the update has started
+parameter:
+	Xstart : X of the rectangle, in the coordinates of the selected Paint image
+	Ystart : Y of the rectangle
+	Width  : width of the rectangle
+	Height : height of the rectangle
+	Image  : whole image data, the rectangle is read out of it
+******************************************************************************/
+void EPD_2in13_V4_Display_WaveformWindow_Async(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image)
+{
+	if(Width == 0 || Height == 0)
+		return;
+
+	EPD_2in13_V4_ReadBusy(); //the previous update must have finished before RAM is written
+	if(EPD_2in13_V4_WriteWindow(Xstart, Ystart, Width, Height, Image))
+		EPD_2in13_V4_StartWaveform();
+}
+
+/******************************************************************************
+function :	Use a fixed panel temperature instead of reading the sensor
+parameter:
+	Temperature : degrees C
+******************************************************************************/
+void EPD_2in13_V4_SetTemperature(int Temperature)
+{
+	EPD_2in13_V4_Temperature = Temperature;
+	EPD_2in13_V4_TemperatureSet = 1;
+	EPD_2in13_V4_Partials = 0; //pick the band again on the next update
+}
+
+/******************************************************************************
+function :	Make the next waveform update a ghost-clearing one
+parameter:
+******************************************************************************/
+void EPD_2in13_V4_RequestClean(void)
+{
+	EPD_2in13_V4_CleanRequest = 1;
+}
+
+/******************************************************************************
+function :	Duration of the last finished update, from the start command to BUSY going low
+parameter:
+******************************************************************************/
+UDOUBLE EPD_2in13_V4_UpdateTime(void)
+{
+	return EPD_2in13_V4_UpdateMs;
 }
 
 /******************************************************************************
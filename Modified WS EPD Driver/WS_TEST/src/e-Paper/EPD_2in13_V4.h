@@ -34,7 +34,7 @@
 #include "../Config/Debug.h"
 #include "../Config/DEV_Config.h"
 #include "../Fonts/fonts.h"
-#include "../GUI/GUI_paint.h"
+#include "../GUI/GUI_Paint.h"
 #include "../Examples/ImageData.h"
 
 
@@ -51,6 +51,38 @@ void EPD_2in13_V4_Display(UBYTE *Image);
 void EPD_2in13_V4_Display_Fast(UBYTE *Image);
 void EPD_2in13_V4_Display_Base(UBYTE *Image);
 void EPD_2in13_V4_Display_Partial(UBYTE *Image);
+//partial refresh of one rectangle of Image, given in the coordinates (rotation, mirroring) of the selected Paint image.
+//X is widened to whole bytes, so the panel gets ~Width/8*Height bytes instead of the whole 4000
+void EPD_2in13_V4_Display_PartialWindow(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image);
+//partial refresh against a copy of the panel RAM kept by the driver: only the rows and byte columns that
+//changed since the last image are sent, an unchanged image sends nothing. Costs 4000 bytes of RAM
+void EPD_2in13_V4_Display_Diff(UBYTE *Image);
+
+//non-blocking updates: the image is sent, the update started and the call returns while the panel refreshes.
+//Completion is signalled by the BUSY falling edge: poll EPD_2in13_V4_IsBusy() or set a callback (runs in interrupt
+//context, or in EPD_2in13_V4_ReadBusy()/_IsBusy() when they see the end first). BUSY rises well within
+//EPD_2in13_V4_BUSY_RISE_MS of the update command; before that a low BUSY does not mean the update has finished
+#define EPD_2in13_V4_BUSY_RISE_MS 10
+void EPD_2in13_V4_Display_Async(UBYTE *Image);
+void EPD_2in13_V4_Display_Partial_Async(UBYTE *Image);
+void EPD_2in13_V4_Display_PartialWindow_Async(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image);
+void EPD_2in13_V4_Display_Diff_Async(UBYTE *Image);
+UBYTE EPD_2in13_V4_IsBusy(void);
+void EPD_2in13_V4_SetDoneCallback(void (*Callback)(void));
+void EPD_2in13_V4_ReadBusy(void);
+UDOUBLE EPD_2in13_V4_UpdateTime(void);
+
+//updates with waveforms loaded by the driver instead of the OTP ones: a fast partial one for charts and,
+//every EPD_2in13_V4_CLEAN_EVERY updates, a ghost-clearing one. The frame counts follow the temperature band,
+//below 5C they fall back to the OTP full refresh. Start from EPD_2in13_V4_Init() and EPD_2in13_V4_Display_Base()
+#define EPD_2in13_V4_CLEAN_EVERY 20
+void EPD_2in13_V4_Display_Waveform(UBYTE *Image);
+void EPD_2in13_V4_Display_Waveform_Async(UBYTE *Image);
+void EPD_2in13_V4_Display_WaveformWindow(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image);
+void EPD_2in13_V4_Display_WaveformWindow_Async(UWORD Xstart, UWORD Ystart, UWORD Width, UWORD Height, UBYTE *Image);
+void EPD_2in13_V4_SetTemperature(int Temperature);
+void EPD_2in13_V4_RequestClean(void);
+
 void EPD_2in13_V4_Sleep(void);
 
 
@@ -0,0 +1,54 @@
+/*
+Paint_DrawChar's glyph blitter against the per-pixel path it replaced (Paint_SetPixel for every glyph bit), on
+a status line: an "12:34:56" Font20 string and a Font16 number, opaque, on a black and white image. Host timings,
+read the ratio: about 5x on x86 -O2 (4.7x at rotation 0 when the blitter went in), not an order of magnitude.
+*/
+#include <GUI_Paint.h>
+#include <chrono>
+
+static const uint32_t ROUNDS = 20000;
+static UBYTE image[16 * 250];
+
+template <typename F>
+static double usPerCall(F f){
+  auto start = std::chrono::steady_clock::now();
+  for(uint32_t n = 0; n < ROUNDS; n++){f();}
+  std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - start;
+  return took.count() / ROUNDS;
+}
+
+//the previous Paint_DrawChar: every bit of the font table through Paint_SetPixel
+static void pixelChar(UWORD Xpoint, UWORD Ypoint, char Acsii_Char, sFONT *Font, UWORD Foreground, UWORD Background){
+  UWORD FontByte = Font->Width / 8 + (Font->Width % 8 ? 1 : 0);
+  const unsigned char *ptr = &Font->table[(Acsii_Char - ' ') * Font->Height * FontByte];
+  for(UWORD Page = 0; Page < Font->Height; Page++){
+    for(UWORD Column = 0; Column < Font->Width; Column++){
+      bool set = ptr[Page * FontByte + Column / 8] & (0x80 >> (Column % 8));
+      Paint_SetPixel(Xpoint + Column, Ypoint + Page, set ? Foreground : Background);
+    }
+  }
+}
+
+static void pixelString(UWORD Xpoint, UWORD Ypoint, const char *s, sFONT *Font){
+  for(; *s; s++, Xpoint += Font->Width){pixelChar(Xpoint, Ypoint, *s, Font, BLACK, WHITE);}
+}
+
+int main(){
+  static const UWORD rotations[2] = {ROTATE_0, ROTATE_90};
+  printf("\"12:34:56\" Font20 + \"123456\" Font16, us per status line, host\n");
+  printf("  rotation  per pixel  blitter  ratio\n");
+  for(UBYTE r = 0; r < 2; r++){
+    Paint_NewImage(image, 122, 250, rotations[r], WHITE);
+    Paint_Clear(WHITE);
+    double a = usPerCall([]{
+      pixelString(0, 0, "12:34:56", &Font20);
+      pixelString(0, 40, "123456", &Font16);
+    });
+    double b = usPerCall([]{
+      Paint_DrawString_EN(0, 0, "12:34:56", &Font20, BLACK, WHITE);
+      Paint_DrawNum(0, 40, 123456, &Font16, BLACK, WHITE);
+    });
+    printf("  %8u  %9.1f  %7.1f  %5.1fx\n", rotations[r], a, b, a / b);
+  }
+  return 0;
+}
@@ -0,0 +1,58 @@
+/*
+The span fills in GUI_Paint (Paint_ClearWindows, filled rectangles and circles) against about the same areas set one
+Paint_SetPixel() at a time, the way they were drawn before, for each pixel size. Host timings: they show the
+ratio between the two, not what the RP2040 takes.
+*/
+#include <GUI_Paint.h>
+#include <chrono>
+
+static const uint32_t ROUNDS = 2000;
+static UBYTE image[128 / 2 * 250]; //the 4 bit image is the largest
+
+template <typename F>
+static double usPerCall(F f){
+  auto start = std::chrono::steady_clock::now();
+  for(uint32_t n = 0; n < ROUNDS; n++){f(n);}
+  std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - start;
+  return took.count() / ROUNDS;
+}
+
+static UWORD color(uint32_t n, UBYTE scale){
+  if(scale == 2) return (n & 1) ? BLACK : WHITE;
+  return n % scale;
+}
+
+static void pixelRect(UWORD X0, UWORD Y0, UWORD X1, UWORD Y1, UWORD Color){
+  for(UWORD y = Y0; y < Y1; y++){
+    for(UWORD x = X0; x < X1; x++){Paint_SetPixel(x, y, Color);}
+  }
+}
+
+static void pixelCircle(int Xc, int Yc, int R, UWORD Color){
+  for(int y = -R; y <= R; y++){
+    for(int x = -R; x <= R; x++){
+      if(x * x + y * y <= R * R){Paint_SetPixel(Xc + x, Yc + y, Color);}
+    }
+  }
+}
+
+int main(){
+  static const UBYTE scales[3] = {2, 4, 16};
+  printf("122x250 image, rotation 90, us per call, host\n");
+  printf("  scale  op                          per pixel   span\n");
+  for(UBYTE s = 0; s < 3; s++){
+    UBYTE scale = scales[s];
+    Paint_NewImage(image, 122, 250, ROTATE_90, WHITE);
+    Paint_SetScale(scale);
+    double a = usPerCall([&](uint32_t n){pixelRect(0, 0, 250, 122, color(n, scale));});
+    double b = usPerCall([&](uint32_t n){Paint_ClearWindows(0, 0, 250, 122, color(n, scale));});
+    printf("  %5u  full screen clear window   %9.1f %6.1f\n", scale, a, b);
+    a = usPerCall([&](uint32_t n){pixelRect(10, 10, 200, 100, color(n, scale));});
+    b = usPerCall([&](uint32_t n){Paint_DrawRectangle(10, 10, 200, 100, color(n, scale), DOT_PIXEL_1X1, DRAW_FILL_FULL);});
+    printf("  %5u  190x90 filled rectangle    %9.1f %6.1f\n", scale, a, b);
+    a = usPerCall([&](uint32_t n){pixelCircle(60, 60, 50, color(n, scale));});
+    b = usPerCall([&](uint32_t n){Paint_DrawCircle(60, 60, 50, color(n, scale), DOT_PIXEL_1X1, DRAW_FILL_FULL);});
+    printf("  %5u  r=50 filled circle         %9.1f %6.1f\n", scale, a, b);
+  }
+  return 0;
+}
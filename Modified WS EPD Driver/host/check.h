@@ -0,0 +1,35 @@
+#ifndef _HOST_CHECK_H
+#define _HOST_CHECK_H
+
+#include <stdio.h>
+
+/*
+Minimal checks for the host tests: CHECK() reports the failing line and carries on, each test program
+returns checkResult() so make stops on the first program with a failure.
+*/
+static int checkfailures = 0;
+static int checkcount = 0;
+
+#define CHECK(cond) do{ \
+    checkcount++; \
+    if(!(cond)){ \
+      checkfailures++; \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while(0)
+
+#define CHECK_NEAR(a, b, tol) do{ \
+    checkcount++; \
+    double _a = (a), _b = (b); \
+    if(!(_a - _b <= (tol) && _b - _a <= (tol))){ \
+      checkfailures++; \
+      fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+    } \
+  } while(0)
+
+static inline int checkResult(const char *name){
+  printf("%s: %d checks, %d failed\n", name, checkcount, checkfailures);
+  return checkfailures ? 1 : 0;
+}
+
+#endif
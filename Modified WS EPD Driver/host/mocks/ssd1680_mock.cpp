@@ -0,0 +1,85 @@
+#include "ssd1680_mock.h"
+
+SSD1680Mock::SSD1680Mock(){
+  memset(ram, 0, sizeof(ram));
+  memset(shown, 0xFF, sizeof(shown));
+}
+
+void SSD1680Mock::pinWritten(uint8_t pin, bool level){
+  if(pin == EPD_CS_PIN){
+    if(cs && !level){selects++;}
+    cs = level;
+  }
+  else if(pin == EPD_DC_PIN){dc = level;}
+  else if(pin == EPD_RST_PIN && !level){ //hardware reset: registers back to default, RAM kept
+    xstart = 0; xend = LINE - 1;
+    ystart = 0; yend = ROWS - 1;
+    xcount = 0; ycount = 0;
+  }
+}
+
+void SSD1680Mock::transfer(uint8_t value){
+  if(cs){
+    ignored++;
+    return;
+  }
+  if(dc){data(value);}
+  else{command(value);}
+}
+
+void SSD1680Mock::busyFor(uint64_t ms){
+  uint64_t now = hostNanos();
+  uint64_t rise = now + (uint64_t)riseus * 1000;
+  hostAt(rise, []{hostSetPin(EPD_BUSY_PIN, HIGH);});
+  hostAt(rise + ms * 1000000, []{hostSetPin(EPD_BUSY_PIN, LOW);});
+  busyuntil = rise + ms * 1000000;
+}
+
+void SSD1680Mock::command(uint8_t value){
+  commands++;
+  if(hostNanos() < busyuntil){busycommands++;} //BUSY is high, or has not risen yet
+  cmd = value;
+  args.clear();
+  switch(cmd){
+  case 0x12: //SWRESET
+    busyFor(resetms);
+    break;
+  case 0x20: //master activation
+    if(updatemode & 0x04){ //display
+      updates++;
+      lastmode = updatemode;
+      memcpy(shown, ram[0], sizeof(shown));
+      busyFor((updatemode & 0x08) ? partialms : fullms);
+    }
+    else{busyFor(loadms);}
+    break;
+  }
+}
+
+void SSD1680Mock::data(uint8_t value){
+  databytes++;
+  if(cmd == 0x24 || cmd == 0x26){
+    uint8_t which = cmd == 0x24 ? 0 : 1;
+    if(xcount < LINE && ycount < ROWS){ram[which][ycount * LINE + xcount] = value;}
+    ramwrites[which]++;
+    if(xcount++ >= xend){
+      xcount = xstart;
+      if(ycount++ >= yend){ycount = ystart;}
+    }
+    return;
+  }
+  args.push_back(value);
+  switch(cmd){
+  case 0x22: updatemode = value; break;
+  case 0x44:
+    if(args.size() == 2){xstart = args[0]; xend = args[1];}
+    break;
+  case 0x45:
+    if(args.size() == 4){ystart = args[0] | args[1] << 8; yend = args[2] | args[3] << 8;}
+    break;
+  case 0x4E: xcount = value; break;
+  case 0x4F:
+    if(args.size() == 2){ycount = args[0] | args[1] << 8;}
+    break;
+  }
+}
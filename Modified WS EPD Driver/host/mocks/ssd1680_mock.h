@@ -0,0 +1,66 @@
+#ifndef _SSD1680_MOCK_H
+#define _SSD1680_MOCK_H
+
+/*
+SSD1680 (the 2.13" V4 panel's controller) on the host SPI bus: commands and data are told apart by DC and
+only taken while CS is low. The two image RAMs, the RAM window and address counter (data entry mode 3, X then
+Y increment, the only one the driver sets) and the update sequence with its BUSY pulse are modelled; waveforms
+and the other settings are only recorded.
+*/
+#include <Arduino.h>
+#include <DEV_Config.h>
+#include <vector>
+#include "host.h"
+
+class SSD1680Mock : public HostSPIDevice {
+public:
+  static const uint16_t LINE = 16; //RAM bytes per row, 128 columns of which 122 are on the glass
+  static const uint16_t ROWS = 250;
+  static const uint16_t RAM_BYTES = LINE * ROWS;
+
+  //BUSY timing: it rises riseus after the update command and falls once the update has run
+  uint32_t riseus = 50;
+  uint32_t fullms = 2000; //display mode 1 (0x22 value without 0x08)
+  uint32_t partialms = 300; //display mode 2
+  uint32_t loadms = 5; //0x22 sequences that do not drive the glass (temperature and LUT loads)
+  uint32_t resetms = 2; //SWRESET
+
+  uint8_t ram[2][RAM_BYTES]; //0x24 (new image) and 0x26 (previous image)
+  uint8_t shown[RAM_BYTES]; //0x24 as of the last display update
+
+  //counters, the tests reset them as they need
+  uint32_t commands = 0;
+  uint32_t databytes = 0;
+  uint32_t selects = 0; //CS falling edges
+  uint32_t ramwrites[2] = {}; //bytes written to each RAM
+  uint32_t updates = 0; //update sequences with the display bit
+  uint8_t lastmode = 0; //0x22 value of the last update
+  uint32_t ignored = 0; //bytes clocked in with CS high
+  uint32_t busycommands = 0; //commands taken between a BUSY sequence's command and the fall of BUSY
+
+  SSD1680Mock();
+  void pinWritten(uint8_t pin, bool level) override;
+  void transfer(uint8_t data) override;
+
+  //RAM byte the row y / column byte x of the 0x24 or 0x26 image
+  uint8_t at(uint8_t which, uint16_t x, uint16_t y) const {return ram[which][y * LINE + x];}
+  bool busy() const {return hostPin(EPD_BUSY_PIN);}
+
+private:
+  void command(uint8_t cmd);
+  void data(uint8_t value);
+  void busyFor(uint64_t ms);
+
+  bool cs = true;
+  bool dc = true;
+  uint8_t cmd = 0;
+  std::vector<uint8_t> args;
+  uint8_t xstart = 0, xend = LINE - 1;
+  uint16_t ystart = 0, yend = ROWS - 1;
+  uint8_t xcount = 0;
+  uint16_t ycount = 0;
+  uint8_t updatemode = 0xff;
+  uint64_t busyuntil = 0; //ns, when the last BUSY pulse falls
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <map>
+#include <vector>
+#include "host.h"
+
+HardwareSerial Serial;
+SPIClassRP2040 SPI1;
+HostSPIStats hostspi = {};
+float hosttemperature = 25;
+
+/*
+Clock and events
+*/
+static uint64_t clock_ns = 0;
+static std::map<std::pair<uint64_t, uint32_t>, std::function<void()>> events; //(time, id), in delivery order
+static uint32_t nextevent = 1;
+static bool inirq = false;
+static int irqdisabled = 0; //noInterrupts() depth
+
+struct Pin {
+  bool level = false;
+  uint8_t mode = INPUT;
+  void (*handler)() = nullptr;
+  int irqmode = 0;
+};
+static Pin pins[30];
+static std::vector<void (*)()> pendingirqs; //edges latched while interrupts were off
+static HostSPIDevice *spidevice = nullptr;
+
+static void runIrq(void (*handler)()){
+  bool was = inirq;
+  inirq = true;
+  handler();
+  inirq = was;
+}
+
+static void deliverPending(){
+  while(!pendingirqs.empty() && !irqdisabled && !inirq){
+    void (*handler)() = pendingirqs.front();
+    pendingirqs.erase(pendingirqs.begin());
+    runIrq(handler);
+  }
+}
+
+uint64_t hostNanos(){
+  return clock_ns;
+}
+
+void hostAdvance(uint64_t ns){
+  uint64_t until = clock_ns + ns;
+  while(!events.empty() && events.begin()->first.first <= until){
+    auto it = events.begin();
+    clock_ns = it->first.first > clock_ns ? it->first.first : clock_ns;
+    std::function<void()> event = it->second;
+    events.erase(it);
+    bool was = inirq;
+    inirq = true;
+    event();
+    inirq = was;
+    deliverPending(); //pin edges the event raised
+  }
+  clock_ns = until;
+}
+
+void hostAt(uint64_t ns, std::function<void()> event){
+  events[{ns, nextevent++}] = event;
+}
+
+void hostSetPin(uint8_t pin, bool level){
+  Pin &p = pins[pin];
+  if(p.level == level) return;
+  p.level = level;
+  if(!p.handler) return;
+  bool fire = p.irqmode == CHANGE || (p.irqmode == FALLING && !level) || (p.irqmode == RISING && level);
+  if(!fire) return;
+  pendingirqs.push_back(p.handler);
+  deliverPending();
+}
+
+bool hostPin(uint8_t pin){
+  return pins[pin].level;
+}
+
+void hostAttachSPI(HostSPIDevice *device){
+  spidevice = device;
+}
+
+void hostReset(){
+  clock_ns = 0;
+  events.clear();
+  inirq = false;
+  irqdisabled = 0;
+  for(Pin &p : pins){p = Pin();}
+  pendingirqs.clear();
+  hostspi = {};
+}
+
+/*
+Arduino API
+*/
+void pinMode(pin_size_t pin, uint8_t mode){
+  pins[pin].mode = mode;
+}
+
+void digitalWrite(pin_size_t pin, uint8_t level){
+  pins[pin].level = level;
+  hostspi.gpiowrites++;
+  hostspi.time += HOST_GPIO_NS;
+  if(spidevice){spidevice->pinWritten(pin, level);}
+  hostAdvance(HOST_GPIO_NS);
+}
+
+int digitalRead(pin_size_t pin){
+  return pins[pin].level;
+}
+
+float analogReadTemp(){
+  return hosttemperature;
+}
+
+unsigned long millis(){
+  return clock_ns / 1000000;
+}
+
+unsigned long micros(){
+  return clock_ns / 1000;
+}
+
+void delay(unsigned long ms){
+  hostAdvance((uint64_t)ms * 1000000);
+}
+
+void delayMicroseconds(unsigned int us){
+  hostAdvance((uint64_t)us * 1000);
+}
+
+int digitalPinToInterrupt(pin_size_t pin){
+  return pin;
+}
+
+void attachInterrupt(int irq, void (*handler)(), int mode){
+  pins[irq].handler = handler;
+  pins[irq].irqmode = mode;
+}
+
+void detachInterrupt(int irq){
+  pins[irq].handler = nullptr;
+}
+
+void noInterrupts(){
+  irqdisabled++;
+}
+
+void interrupts(){
+  if(irqdisabled){irqdisabled--;}
+  deliverPending();
+}
+
+/*
+SPI
+*/
+uint8_t SPIClassRP2040::transfer(uint8_t data){
+  transfer(&data, nullptr, 1);
+  return 0;
+}
+
+void SPIClassRP2040::transfer(const void *txbuf, void *rxbuf, size_t count){
+  const uint8_t *tx = (const uint8_t *)txbuf;
+  for(size_t i = 0; i < count; i++){
+    if(spidevice){spidevice->transfer(tx ? tx[i] : 0xFF);}
+  }
+  if(rxbuf){memset(rxbuf, 0, count);} //no MISO on the panel
+  uint64_t ns = HOST_SPI_CALL_NS + (uint64_t)count * 8 * 1000000000 / _settings.clock;
+  hostspi.calls++;
+  hostspi.bytes += count;
+  hostspi.time += ns;
+  hostAdvance(ns);
+}
@@ -0,0 +1,70 @@
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+/*
+Host build of the arduino-pico core, only the parts the Waveshare driver uses. Time is virtual: millis()/micros()
+read a clock that only moves when the driver waits or drives the bus, so a run gives the same result every time
+and is independent of how fast the host is. See host.h for the test-side controls.
+*/
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint8_t pin_size_t;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+//Serial output is dropped, the driver only prints Debug() progress
+class Print {
+public:
+  size_t print(const char *){return 0;}
+  size_t print(char){return 0;}
+  size_t print(int, int = DEC){return 0;}
+  size_t print(unsigned int, int = DEC){return 0;}
+  size_t print(long, int = DEC){return 0;}
+  size_t print(unsigned long, int = DEC){return 0;}
+  size_t print(double, int = 2){return 0;}
+  template <typename T> size_t println(T v){return print(v);}
+  template <typename T> size_t println(T v, int format){return print(v, format);}
+  size_t println(){return 0;}
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long){}
+  operator bool(){return true;}
+};
+extern HardwareSerial Serial;
+
+void pinMode(pin_size_t pin, uint8_t mode);
+void digitalWrite(pin_size_t pin, uint8_t level);
+int digitalRead(pin_size_t pin);
+float analogReadTemp();
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+int digitalPinToInterrupt(pin_size_t pin);
+void attachInterrupt(int irq, void (*handler)(), int mode);
+void detachInterrupt(int irq);
+void noInterrupts();
+void interrupts();
+
+#endif
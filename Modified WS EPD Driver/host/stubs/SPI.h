@@ -0,0 +1,34 @@
+#ifndef _HOST_SPI_H
+#define _HOST_SPI_H
+
+#include <Arduino.h>
+#include "host.h"
+
+class SPISettings {
+public:
+  SPISettings(uint32_t clock = 4000000, uint8_t bitorder = 1, uint8_t datamode = 0) : clock(clock) {(void)bitorder; (void)datamode;}
+  uint32_t clock;
+};
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+//hands every byte to the device from hostAttachSPI(), each call costs HOST_SPI_CALL_NS plus 8 clocks per byte
+class SPIClassRP2040 {
+public:
+  bool setCS(pin_size_t){return true;}
+  bool setSCK(pin_size_t){return true;}
+  bool setTX(pin_size_t){return true;}
+  void begin(){}
+  void end(){}
+  void beginTransaction(SPISettings settings){_settings = settings;}
+  void endTransaction(){}
+  uint8_t transfer(uint8_t data);
+  void transfer(const void *txbuf, void *rxbuf, size_t count);
+
+private:
+  SPISettings _settings;
+};
+extern SPIClassRP2040 SPI1;
+
+#endif
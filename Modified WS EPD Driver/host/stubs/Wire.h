@@ -0,0 +1,7 @@
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+//Debug.h includes Wire.h, nothing in the driver uses I2C
+#include <Arduino.h>
+
+#endif
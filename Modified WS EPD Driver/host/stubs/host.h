@@ -0,0 +1,52 @@
+#ifndef _HOST_H
+#define _HOST_H
+
+/*
+Test-side controls of the host board. Not part of the Arduino API, the driver never includes this.
+
+Time: a virtual clock in ns that moves when the driver waits (delay(), SPI transfers, GPIO writes) and never
+on its own. Hardware events (the panel's BUSY edges) are queued with hostAt() and run in interrupt context
+once the clock reaches them, the way the RP2040 delivers the GPIO interrupts the driver attaches.
+*/
+#include <stdint.h>
+#include <functional>
+
+uint64_t hostNanos();
+//time passes, due events are delivered
+void hostAdvance(uint64_t ns);
+//queues a hardware event at an absolute time in ns
+void hostAt(uint64_t ns, std::function<void()> event);
+
+//drives an input pin from outside (BUSY), fires the interrupt attached to it on a matching edge
+void hostSetPin(uint8_t pin, bool level);
+bool hostPin(uint8_t pin);
+
+//the device on the SPI bus: sees every byte and every change of the pins the driver writes (CS, DC, RST)
+class HostSPIDevice {
+public:
+  virtual ~HostSPIDevice(){}
+  virtual void pinWritten(uint8_t pin, bool level) = 0;
+  virtual void transfer(uint8_t data) = 0;
+};
+void hostAttachSPI(HostSPIDevice *device);
+
+//what the panel interface has carried since the last reset of hostspi
+struct HostSPIStats {
+  uint32_t calls; //SPI1.transfer() calls
+  uint32_t bytes;
+  uint32_t gpiowrites; //digitalWrite() calls
+  uint64_t time; //ns spent in transfers and GPIO writes
+};
+extern HostSPIStats hostspi;
+
+//cost model of the arduino-pico calls, in ns at 133MHz
+static const uint64_t HOST_GPIO_NS = 100; //digitalWrite(): pin checks and gpio_put()
+static const uint64_t HOST_SPI_CALL_NS = 1000; //SPI1.transfer(): FIFO setup and the wait for the last RX byte
+
+//clock, events, pins and interrupts back to power-on
+void hostReset();
+
+//RP2040 temperature analogReadTemp() returns
+extern float hosttemperature;
+
+#endif
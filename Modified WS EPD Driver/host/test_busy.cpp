@@ -0,0 +1,136 @@
+/*
+Asynchronous updates and the BUSY handling on the SSD1680 model: the update is finished by the BUSY falling
+edge, by IsBusy() when the edge was missed or by ReadBusy(), always through one path that calls the done
+callback exactly once; a BUSY line that has not risen yet does not end an update that has just started,
+nor the SWRESET and temperature loads of the init sequences, and nothing is sent to a busy panel.
+*/
+#include <EPD_2in13_V4.h>
+#include "ssd1680_mock.h"
+#include "check.h"
+#include "host.h"
+
+static SSD1680Mock panel;
+static UBYTE image[SSD1680Mock::RAM_BYTES];
+static uint32_t donecalls = 0;
+
+static void done(){
+  donecalls++;
+}
+
+//the falling edge calls back while the caller does something else
+static void testEdge(){
+  uint32_t calls = donecalls;
+  uint64_t start = hostNanos();
+  EPD_2in13_V4_Display_Async(image);
+  CHECK(hostNanos() - start < 20000000); //the image is sent, the update is not waited for
+  CHECK(!panel.busy()); //BUSY has not risen yet
+  CHECK(EPD_2in13_V4_IsBusy());
+  delay(1000);
+  CHECK(panel.busy());
+  CHECK(EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls);
+  delay(panel.fullms);
+  CHECK(!panel.busy());
+  CHECK(donecalls == calls + 1);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls + 1);
+  CHECK(EPD_2in13_V4_UpdateTime() == panel.fullms);
+}
+
+//without the interrupt IsBusy() ends the update once BUSY has been high and is low again
+static void testMissedEdge(){
+  detachInterrupt(digitalPinToInterrupt(EPD_BUSY_PIN));
+  uint32_t calls = donecalls;
+  EPD_2in13_V4_Display_Partial_Async(image);
+  delay(1);
+  CHECK(EPD_2in13_V4_IsBusy()); //sees BUSY high
+  delay(panel.partialms);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls + 1);
+
+  //not polled while BUSY was high: low long after the update command is the end too
+  EPD_2in13_V4_Display_Partial_Async(image);
+  delay(panel.partialms + 1);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls + 2);
+
+  //a slow BUSY: still low a few ms after the update command, that is not the end
+  panel.riseus = 5000;
+  EPD_2in13_V4_Display_Partial_Async(image);
+  delay(2);
+  CHECK(!panel.busy());
+  CHECK(EPD_2in13_V4_IsBusy());
+  delay(4);
+  CHECK(EPD_2in13_V4_IsBusy());
+  delay(panel.partialms);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls + 3);
+  panel.riseus = 50;
+
+  //waited for: ReadBusy() finishes the update and calls back
+  EPD_2in13_V4_Display_Partial(image);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls + 4);
+}
+
+//edge and waiting caller both see the end: one callback
+static void testOnce(){
+  EPD_2in13_V4_Init(); //attaches the BUSY interrupt again
+  uint32_t calls = donecalls;
+  EPD_2in13_V4_Display(image); //the edge arrives while ReadBusy() waits
+  CHECK(donecalls == calls + 1);
+
+  //the edge is held while interrupts are off, IsBusy() gets there first
+  EPD_2in13_V4_Display_Partial_Async(image);
+  noInterrupts();
+  delay(panel.partialms + 1);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls + 2);
+  interrupts(); //the held edge runs the interrupt, the update is already finished
+  CHECK(donecalls == calls + 2);
+}
+
+//BUSY rising late after SWRESET (0x12) and the temperature loads (0x20): no command goes out before it falls
+static void testLateRise(){
+  panel.riseus = 5000;
+  uint32_t calls = donecalls;
+  uint32_t busy = panel.busycommands;
+  EPD_2in13_V4_Init();
+  CHECK(panel.busycommands == busy);
+  EPD_2in13_V4_Init_Fast();
+  CHECK(panel.busycommands == busy);
+  CHECK(!EPD_2in13_V4_IsBusy());
+  CHECK(donecalls == calls); //the temperature loads are not display updates
+  panel.riseus = 50;
+  EPD_2in13_V4_Init();
+}
+
+//the blocking calls that write RAM wait for an update started by an _Async one
+static void testAfterAsync(){
+  uint32_t busy = panel.busycommands;
+  uint32_t calls = donecalls;
+  EPD_2in13_V4_Display_Partial_Async(image);
+  EPD_2in13_V4_Clear();
+  EPD_2in13_V4_Display_Partial_Async(image);
+  EPD_2in13_V4_Display_Fast(image);
+  EPD_2in13_V4_Display_Partial_Async(image);
+  EPD_2in13_V4_Display_Base(image);
+  EPD_2in13_V4_Display_Partial_Async(image);
+  EPD_2in13_V4_Display(image);
+  CHECK(panel.busycommands == busy);
+  CHECK(donecalls == calls + 8);
+}
+
+int main(){
+  hostAttachSPI(&panel);
+  DEV_Module_Init();
+  EPD_2in13_V4_Init();
+  EPD_2in13_V4_Display_Base(image);
+  EPD_2in13_V4_SetDoneCallback(done);
+  testEdge();
+  testMissedEdge();
+  testOnce();
+  testLateRise();
+  testAfterAsync();
+  return checkResult("test_busy");
+}
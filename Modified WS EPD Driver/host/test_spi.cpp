@@ -0,0 +1,103 @@
+/*
+Framebuffer streaming on the SSD1680 model: a whole image goes out as one block with DC and CS set once, lands
+in the right RAM, and costs little more than its bytes at the SPI clock. The per-byte SendData() the driver
+used before is timed on the same bus for comparison.
+*/
+#include <EPD_2in13_V4.h>
+#include "ssd1680_mock.h"
+#include "check.h"
+#include "host.h"
+
+static SSD1680Mock panel;
+static UBYTE image[SSD1680Mock::RAM_BYTES];
+
+static void fillImage(uint32_t seed){
+  for(UDOUBLE i = 0; i < sizeof(image); i++){
+    seed = seed * 1103515245 + 12345;
+    image[i] = seed >> 16;
+  }
+}
+
+//the driver's SendCommand() and, for every byte, SendData(): DC and CS toggled around a single-byte transfer
+static void sendPerByte(UBYTE Reg, UBYTE *Data, UDOUBLE Len){
+  DEV_Digital_Write(EPD_DC_PIN, 0);
+  DEV_Digital_Write(EPD_CS_PIN, 0);
+  DEV_SPI_WriteByte(Reg);
+  DEV_Digital_Write(EPD_CS_PIN, 1);
+  for(UDOUBLE i = 0; i < Len; i++){
+    DEV_Digital_Write(EPD_DC_PIN, 1);
+    DEV_Digital_Write(EPD_CS_PIN, 0);
+    DEV_SPI_WriteByte(Data[i]);
+    DEV_Digital_Write(EPD_CS_PIN, 1);
+  }
+}
+
+static void testDisplay(){
+  fillImage(1);
+  uint32_t selects = panel.selects;
+  hostspi = {};
+  EPD_2in13_V4_Display_Async(image);
+  HostSPIStats block = hostspi;
+  CHECK(!memcmp(panel.ram[0], image, sizeof(image)));
+  CHECK(panel.ramwrites[0] == sizeof(image));
+  CHECK(panel.ignored == 0);
+  CHECK(panel.selects - selects == 5); //0x24, the image, 0x22, its value, 0x20
+  CHECK(block.calls == 5);
+  CHECK(block.bytes == sizeof(image) + 4);
+  uint64_t wire = (uint64_t)block.bytes * 8 * 1000000000 / 4000000; //the bytes at 4MHz
+  CHECK(block.time < wire + wire / 100);
+  EPD_2in13_V4_ReadBusy();
+  CHECK(!memcmp(panel.shown, image, sizeof(image)));
+
+  hostspi = {};
+  fillImage(2);
+  sendPerByte(0x24, image, sizeof(image));
+  CHECK(!memcmp(panel.ram[0], image, sizeof(image))); //the same bytes, the same RAM
+  HostSPIStats perbyte = hostspi;
+  CHECK(perbyte.calls == sizeof(image) + 1);
+  CHECK(block.time < perbyte.time);
+  printf("frame of %u bytes: block %u calls, %.2f ms, %.0f kB/s; per byte %u calls, %.2f ms, %.0f kB/s\n",
+         (unsigned)sizeof(image), block.calls, block.time / 1e6, block.bytes * 1e6 / block.time,
+         perbyte.calls, perbyte.time / 1e6, perbyte.bytes * 1e6 / perbyte.time);
+}
+
+//a base image fills both RAMs, one block each
+static void testBase(){
+  fillImage(3);
+  uint32_t writes[2] = {panel.ramwrites[0], panel.ramwrites[1]};
+  hostspi = {};
+  EPD_2in13_V4_Display_Base(image);
+  CHECK(!memcmp(panel.ram[0], image, sizeof(image)));
+  CHECK(!memcmp(panel.ram[1], image, sizeof(image)));
+  CHECK(panel.ramwrites[0] - writes[0] == sizeof(image));
+  CHECK(panel.ramwrites[1] - writes[1] == sizeof(image));
+  CHECK(hostspi.calls == 7); //0x24, image, 0x26, image, 0x22, its value, 0x20
+  CHECK(panel.lastmode == 0xf7);
+}
+
+//a clear streams one byte value a row buffer at a time, still inside one CS assertion
+static void testClear(){
+  uint32_t selects = panel.selects;
+  hostspi = {};
+  EPD_2in13_V4_Clear();
+  for(UDOUBLE i = 0; i < sizeof(image); i++){
+    if(panel.ram[0][i] != 0xFF){
+      CHECK(panel.ram[0][i] == 0xFF);
+      break;
+    }
+  }
+  CHECK(panel.selects - selects == 5);
+  CHECK(hostspi.calls == 4 + sizeof(image) / 32 + (sizeof(image) % 32 != 0));
+  CHECK(!memcmp(panel.shown, panel.ram[0], sizeof(image)));
+}
+
+int main(){
+  hostAttachSPI(&panel);
+  DEV_Module_Init();
+  EPD_2in13_V4_Init();
+  CHECK(!panel.busy());
+  testDisplay();
+  testBase();
+  testClear();
+  return checkResult("test_spi");
+}